@@ -1,18 +1,58 @@
 #ifndef FENWICK_TREE_HPP
 #define FENWICK_TREE_HPP
 
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <ranges>
 #include <stdexcept>
 #include <vector>
 
+// Value types a Fenwick tree can sum: an abelian group under + and - whose
+// value-initialized T{} is the identity, such as the integer and floating
+// point types or user-defined vectors and residues.
+template <typename T>
+concept FenwickValue = std::regular<T> && requires(T a, const T b) {
+  { a + b } -> std::convertible_to<T>;
+  { a - b } -> std::convertible_to<T>;
+  a += b;
+};
+
 // Fenwick Tree (Binary Indexed Tree) for handling
 // prefix sums over a 1D array with point updates.
+//
+// Use a 64-bit T for counters that may exceed 2^31; the default int is kept
+// for compatibility.
+template <FenwickValue T = int>
 class FenwickTree {
  public:
-  explicit FenwickTree(std::size_t n) : size_(n), fenw_(n + 1, 0) {}
+  explicit FenwickTree(std::size_t n) : size_(n), fenw_(n + 1, T{}) {}
+
+  // Builds the tree over the given values in O(n): each node adds its
+  // partial sum into its parent once, instead of n separate updates.
+  template <std::ranges::input_range R>
+    requires std::convertible_to<std::ranges::range_reference_t<R>, T>
+  explicit FenwickTree(R&& values) : size_(0), fenw_(1, T{}) {
+    if constexpr (std::ranges::sized_range<R>) {
+      fenw_.reserve(std::ranges::size(values) + 1);
+    }
+    for (auto&& value : values) {
+      fenw_.push_back(static_cast<T>(value));
+    }
+    size_ = fenw_.size() - 1;
+    for (std::size_t idx = 1; idx <= size_; ++idx) {
+      std::size_t parent = idx + lowBit(idx);
+      if (parent <= size_) {
+        fenw_[parent] += fenw_[idx];
+      }
+    }
+  }
+
+  [[nodiscard]] std::size_t size() const { return size_; }
 
   // Add 'delta' to element at index 'idx'
   // Assumes 0-based indexing externally
-  void update(std::size_t idx, int delta) {
+  void update(std::size_t idx, const T& delta) {
     if (idx >= size_) {
       throw std::out_of_range("Index out of range in FenwickTree::update");
     }
@@ -20,37 +60,59 @@ class FenwickTree {
     idx += 1;
     while (idx < fenw_.size()) {
       fenw_[idx] += delta;
-      idx += idx & (-static_cast<int>(idx));
+      idx += lowBit(idx);
     }
   }
 
   // Returns the sum of elements in [0..idx]
-  // If idx < 0, returns 0
-  [[nodiscard]] int query(std::size_t idx) const {
+  [[nodiscard]] T query(std::size_t idx) const {
     if (idx >= size_) {
       throw std::out_of_range("Index out of range in FenwickTree::query");
     }
     idx += 1;
-    int result = 0;
+    T result{};
     while (idx > 0) {
       result += fenw_[idx];
-      idx -= idx & (-static_cast<int>(idx));
+      idx -= lowBit(idx);
     }
     return result;
   }
 
   // Returns the sum of elements in [left..right]
   // If left > right, returns 0
-  [[nodiscard]] int rangeQuery(std::size_t left, std::size_t right) const {
+  [[nodiscard]] T rangeQuery(std::size_t left, std::size_t right) const {
     if (left > right) {
-      return 0;
+      return T{};
+    }
+    return query(right) - (left == 0 ? T{} : query(left - 1));
+  }
+
+  // Returns the smallest index whose prefix sum [0..idx] is not less than
+  // 'sum', or size() if the total is less than 'sum'. Descends the implicit
+  // tree by binary lifting in O(log n), without separate queries.
+  // Requires every element to be non-negative, so prefix sums never decrease.
+  [[nodiscard]] std::size_t lowerBound(T sum) const
+    requires std::totally_ordered<T>
+  {
+    std::size_t pos = 0;
+    for (std::size_t step = std::bit_floor(size_); step > 0; step >>= 1) {
+      if (pos + step <= size_ && fenw_[pos + step] < sum) {
+        pos += step;
+        sum = sum - fenw_[pos];
+      }
     }
-    return query(right) - (left == 0 ? 0 : query(left - 1));
+    return pos;
   }
 
  private:
+  // Lowest set bit of idx, the span of the Fenwick node stored at idx.
+  static std::size_t lowBit(std::size_t idx) { return idx & (~idx + 1); }
+
   std::size_t size_;
-  std::vector<int> fenw_;
+  std::vector<T> fenw_;
 };
 
+template <std::ranges::input_range R>
+FenwickTree(R&&) -> FenwickTree<std::ranges::range_value_t<R>>;
+
 #endif  // FENWICK_TREE_HPP
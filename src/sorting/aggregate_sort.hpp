@@ -0,0 +1,439 @@
+#ifndef AGGREGATE_SORT_HPP
+#define AGGREGATE_SORT_HPP
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "insertion_sort.hpp"
+#include "merge_sort.hpp"
+#include "radix_sort.hpp"
+#include "sort_observer.hpp"
+#include "sorting_concepts.hpp"
+#include "sorting_network.hpp"
+
+// Folds the second of two equal elements into the first: reduce(kept, next).
+template <typename Reduce, typename T>
+concept SortReducer = std::invocable<Reduce&, T&, T&&>;
+
+// Reducer of sortUnique: keeps the first of each group of equal elements.
+struct KeepFirst {
+  template <typename T>
+  constexpr void operator()(T& /*kept*/, T&& /*next*/) const noexcept {}
+};
+
+/**
+ * @brief Collapses every group of adjacent elements for which same holds
+ *        into its first element, folding the others into it in order
+ *
+ * @return End of the collapsed range
+ */
+template <std::random_access_iterator It, typename Same, typename Reduce>
+It collapseEqual(It first, It last, Same same, Reduce& reduce) {
+  if (first == last) {
+    return last;
+  }
+  It out = first;
+  for (It it = std::next(first); it != last; ++it) {
+    if (same(*out, *it)) {
+      std::invoke(reduce, *out, std::move(*it));
+    } else if (++out != it) {
+      *out = std::move(*it);
+    }
+  }
+  return std::next(out);
+}
+
+/**
+ * @brief Insertion sort of [first, last) that folds each element equal to
+ *        one already placed into it instead of inserting it
+ *
+ * Shifts happen only among the distinct elements, so a block that is mostly
+ * duplicates costs little more than one comparison scan per element.
+ *
+ * @return End of the sorted distinct elements
+ */
+template <std::random_access_iterator It, typename Compare, typename Reduce,
+          SortObserver Observer = NullSortObserver>
+It insertionSortReduce(It first, It last, Compare comp, Reduce& reduce, Observer observer = {}) {
+  It sortedEnd = first;
+  for (It it = first; it != last; ++it) {
+    It position = sortedEnd;
+    while (position != first && comp(*it, *std::prev(position))) {
+      --position;
+    }
+    if (position != first && !comp(*std::prev(position), *it)) {
+      std::invoke(reduce, *std::prev(position), std::move(*it));
+      continue;
+    }
+    if (position != it) {
+      auto value = std::move(*it);
+      std::move_backward(position, sortedEnd, std::next(sortedEnd));
+      *position = std::move(value);
+      observer.onMove(static_cast<std::size_t>(sortedEnd - position) + 2);
+    }
+    ++sortedEnd;
+  }
+  return sortedEnd;
+}
+
+/**
+ * @brief Stable merge of two sorted runs without duplicates into out, where
+ *        an element of the second run equal to the head of the first is
+ *        folded into that head instead of being written
+ *
+ * @param collapsed Incremented once per folded element
+ */
+template <std::random_access_iterator In, typename Out, typename Compare, typename Reduce>
+Out mergeReduceRuns(In first1, In last1, In first2, In last2, Out out, Compare comp,
+                    Reduce& reduce, std::ptrdiff_t& collapsed) {
+  while (first1 != last1 && first2 != last2) {
+    if (comp(*first2, *first1)) {
+      *out++ = std::move(*first2++);
+      continue;
+    }
+    if (!comp(*first1, *first2)) {
+      std::invoke(reduce, *first1, std::move(*first2++));
+      ++collapsed;
+    }
+    *out++ = std::move(*first1++);
+  }
+  out = std::move(first1, last1, out);
+  return std::move(first2, last2, out);
+}
+
+/**
+ * @brief Sorts [first, last) by comp and collapses each group of equal
+ *        elements into its first element with reduce, in one merge sort
+ *
+ * Runs of kMergeSortRunLength are insertion sorted in place with each
+ * duplicate folded as soon as it is met, and every merge pass folds the equal
+ * heads of its two runs together, so each pass writes only the distinct
+ * elements of its runs. With heavy duplication the passes shrink
+ * geometrically, and the duplicates are never moved by a separate unique
+ * pass. Equal elements are folded in their input order.
+ *
+ * @param comp Observed comparator
+ * @return End of the sorted distinct elements
+ */
+template <std::random_access_iterator It, typename Compare, typename Reduce,
+          SortObserver Observer = NullSortObserver>
+It mergeSortReduceImpl(It first, It last, Compare comp, Reduce& reduce, Observer observer = {}) {
+  auto n = last - first;
+  struct Run {
+    std::ptrdiff_t begin;
+    std::ptrdiff_t end;
+  };
+  std::vector<Run> runs;
+  std::ptrdiff_t distinct = 0;
+  for (std::ptrdiff_t run = 0; run < n; run += kMergeSortRunLength) {
+    auto runEnd = first + std::min(run + kMergeSortRunLength, n);
+    auto end = insertionSortReduce(first + run, runEnd, comp, reduce, observer) - first;
+    runs.push_back({run, end});
+    distinct += end - run;
+  }
+  if (runs.size() <= 1) {
+    return runs.empty() ? first : first + runs[0].end;
+  }
+
+  // Merges neighbouring runs from src into the sink and returns the new runs.
+  auto mergeLevel = [&](auto src, auto sink, auto position) {
+    std::vector<Run> merged;
+    for (std::size_t r = 0; r < runs.size(); r += 2) {
+      std::ptrdiff_t begin = position(sink);
+      if (r + 1 == runs.size()) {
+        sink = std::move(src + runs[r].begin, src + runs[r].end, sink);
+      } else {
+        std::ptrdiff_t collapsed = 0;
+        sink = mergeReduceRuns(src + runs[r].begin, src + runs[r].end, src + runs[r + 1].begin,
+                               src + runs[r + 1].end, sink, comp, reduce, collapsed);
+        distinct -= collapsed;
+      }
+      merged.push_back({begin, position(sink)});
+    }
+    observer.onMove(static_cast<std::size_t>(merged.back().end));
+    runs = std::move(merged);
+  };
+
+  // The first pass fills the buffer, so elements need not be default
+  // constructible and the buffer holds only what survived the runs.
+  using T = std::iter_value_t<It>;
+  observer.onAllocate(static_cast<std::size_t>(distinct) * sizeof(T));
+  std::vector<T> buffer;
+  buffer.reserve(static_cast<std::size_t>(distinct));
+  std::size_t pass = 0;
+  observer.onRecurse(++pass);
+  mergeLevel(first, std::back_inserter(buffer),
+             [&buffer](const auto&) { return static_cast<std::ptrdiff_t>(buffer.size()); });
+  bool inBuffer = true;
+  while (runs.size() > 1) {
+    observer.onRecurse(++pass);
+    if (inBuffer) {
+      mergeLevel(buffer.begin(), first, [first](It out) { return out - first; });
+    } else {
+      mergeLevel(first, buffer.begin(), [&buffer](auto out) { return out - buffer.begin(); });
+    }
+    inBuffer = !inBuffer;
+  }
+  if (inBuffer) {
+    observer.onMove(static_cast<std::size_t>(runs[0].end));
+    std::move(buffer.begin(), buffer.begin() + runs[0].end, first);
+  }
+  return first + runs[0].end;
+}
+
+/**
+ * @brief Sorts [first, last) and folds every group of elements that are
+ *        equal under comp into its first element with reduce
+ *
+ * reduce(kept, std::move(next)) is called once per duplicate, in input order
+ * within each group, e.g. to sum counts or combine payloads. The distinct
+ * elements end up sorted at the front; the rest of the range is left in a
+ * valid but unspecified state.
+ *
+ * @return End of the sorted distinct elements
+ */
+template <std::random_access_iterator It, typename Reduce, typename Compare = std::ranges::less,
+          typename Proj = std::identity, SortObserver Observer = NullSortObserver>
+  requires SortableIterator<It, Compare, Proj> && SortReducer<Reduce, std::iter_value_t<It>>
+It sortReduce(It first, It last, Reduce reduce, Compare comp = {}, Proj proj = {},
+              Observer observer = {}) {
+  return mergeSortReduceImpl(first, last,
+                             observeComparisons(projectedComparator(comp, proj), observer), reduce,
+                             observer);
+}
+
+template <std::ranges::random_access_range R, typename Reduce,
+          typename Compare = std::ranges::less, typename Proj = std::identity,
+          SortObserver Observer = NullSortObserver>
+  requires SortableRange<R, Compare, Proj> && SortReducer<Reduce, std::ranges::range_value_t<R>>
+std::ranges::borrowed_iterator_t<R> sortReduce(R&& range, Reduce reduce, Compare comp = {},
+                                               Proj proj = {}, Observer observer = {}) {
+  auto first = std::ranges::begin(range);
+  return sortReduce(first, std::ranges::next(first, std::ranges::end(range)), reduce, comp, proj,
+                    observer);
+}
+
+/**
+ * @brief Sorts [first, last) and keeps the first of every group of equal
+ *        elements, like a sort followed by std::unique but in one pass
+ *
+ * @return End of the sorted distinct elements
+ */
+template <std::random_access_iterator It, typename Compare = std::ranges::less,
+          typename Proj = std::identity, SortObserver Observer = NullSortObserver>
+  requires SortableIterator<It, Compare, Proj>
+It sortUnique(It first, It last, Compare comp = {}, Proj proj = {}, Observer observer = {}) {
+  return sortReduce(first, last, KeepFirst{}, comp, proj, observer);
+}
+
+template <std::ranges::random_access_range R, typename Compare = std::ranges::less,
+          typename Proj = std::identity, SortObserver Observer = NullSortObserver>
+  requires SortableRange<R, Compare, Proj>
+std::ranges::borrowed_iterator_t<R> sortUnique(R&& range, Compare comp = {}, Proj proj = {},
+                                               Observer observer = {}) {
+  auto first = std::ranges::begin(range);
+  return sortUnique(first, std::ranges::next(first, std::ranges::end(range)), comp, proj,
+                    observer);
+}
+
+/**
+ * @brief Stable LSD radix sort of records by key that folds records with
+ *        equal keys into the first of them during its last pass
+ *
+ * The passes before the last move every record, as they must: equal keys
+ * only meet once the last digit is placed. In that last pass, though, each
+ * bucket receives its records in final order, so a record whose key equals
+ * the one just written to its bucket is folded into it with reduce instead
+ * of being written. A closing sweep packs the buckets together and, when the
+ * passes ended in buffer, doubles as the move back, so it moves only the
+ * distinct records. Keys compare equal when their radixKey is equal, except
+ * that -0.0 and 0.0 share one key, as they compare equal under <.
+ *
+ * @param buffer Scratch space of at least data.size() records
+ * @return Number of distinct records, sorted at the front of data
+ * @throws std::invalid_argument if buffer is too small
+ */
+template <std::movable R, typename KeyFn, typename Reduce,
+          SortObserver Observer = NullSortObserver>
+  requires RadixSortable<RadixKeyOf<R, KeyFn>> && SortReducer<Reduce, R>
+std::size_t radixSortReduceBy(std::span<R> data, std::span<R> buffer, KeyFn key, Reduce reduce,
+                              Observer observer = {}) {
+  using K = RadixKeyOf<R, KeyFn>;
+  std::size_t n = data.size();
+  auto keyOf = [&key](const R& record) {
+    auto value = static_cast<K>(std::invoke(key, record));
+    if constexpr (std::floating_point<K>) {
+      // -0.0 == 0.0, so both zeros take the radix key of 0.0 and fold together.
+      if (value == K{}) {
+        value = K{};
+      }
+    }
+    return radixKey(value);
+  };
+  auto same = [&keyOf](const R& a, const R& b) { return keyOf(a) == keyOf(b); };
+  if (n <= kRadixSortInsertionThreshold) {
+    auto byKey = [&keyOf](const R& a, const R& b) { return keyOf(a) < keyOf(b); };
+    insertionSortImpl(data.begin(), data.end(), observeComparisons(byKey, observer), observer);
+    return static_cast<std::size_t>(collapseEqual(data.begin(), data.end(), same, reduce) -
+                                    data.begin());
+  }
+  if (buffer.size() < n) {
+    throw std::invalid_argument("radixSortReduceBy buffer is smaller than the input");
+  }
+
+  auto digit = [&keyOf](const R& record, unsigned pass) {
+    return static_cast<std::size_t>((keyOf(record) >> (pass * kRadixBits)) & (kRadixBuckets - 1));
+  };
+  std::array<std::array<std::size_t, kRadixBuckets>, kRadixPasses<K>> counts{};
+  for (const R& record : data) {
+    for (unsigned pass = 0; pass < kRadixPasses<K>; ++pass) {
+      ++counts[pass][digit(record, pass)];
+    }
+  }
+  std::vector<unsigned> passes;
+  for (unsigned pass = 0; pass < kRadixPasses<K>; ++pass) {
+    if (counts[pass][digit(data[0], pass)] != n) {
+      passes.push_back(pass);
+    }
+  }
+  if (passes.empty()) {
+    return static_cast<std::size_t>(collapseEqual(data.begin(), data.end(), same, reduce) -
+                                    data.begin());
+  }
+
+  std::span<R> src = data;
+  std::span<R> dst = buffer.first(n);
+  std::array<std::size_t, kRadixBuckets> starts{};
+  std::array<std::size_t, kRadixBuckets> ends{};
+  for (std::size_t p = 0; p < passes.size(); ++p) {
+    unsigned pass = passes[p];
+    observer.onRecurse(p + 1);
+    observer.onMove(n);
+    std::size_t sum = 0;
+    for (std::size_t b = 0; b < kRadixBuckets; ++b) {
+      starts[b] = sum;
+      sum += counts[pass][b];
+    }
+    ends = starts;
+    if (p + 1 < passes.size()) {
+      for (R& record : src) {
+        dst[ends[digit(record, pass)]++] = std::move(record);
+      }
+      std::swap(src, dst);
+      continue;
+    }
+    // The key last written to each bucket, so a duplicate is recognized
+    // without reading back what was written.
+    std::array<decltype(keyOf(data[0])), kRadixBuckets> lastKeys{};
+    for (R& record : src) {
+      auto recordKey = keyOf(record);
+      auto b = static_cast<std::size_t>((recordKey >> (pass * kRadixBits)) & (kRadixBuckets - 1));
+      if (ends[b] != starts[b] && lastKeys[b] == recordKey) {
+        std::invoke(reduce, dst[ends[b] - 1], std::move(record));
+      } else {
+        lastKeys[b] = recordKey;
+        dst[ends[b]++] = std::move(record);
+      }
+    }
+  }
+
+  std::size_t out = 0;
+  for (std::size_t b = 0; b < kRadixBuckets; ++b) {
+    for (std::size_t i = starts[b]; i < ends[b]; ++i, ++out) {
+      if (dst.data() != data.data() || i != out) {
+        data[out] = std::move(dst[i]);
+      }
+    }
+  }
+  observer.onMove(out);
+  return out;
+}
+
+/**
+ * @brief radixSortReduceBy that allocates its own scratch space
+ */
+template <std::movable R, typename KeyFn, typename Reduce,
+          SortObserver Observer = NullSortObserver>
+  requires RadixSortable<RadixKeyOf<R, KeyFn>> && SortReducer<Reduce, R> &&
+           std::default_initializable<R>
+std::size_t radixSortReduceBy(std::span<R> data, KeyFn key, Reduce reduce,
+                              Observer observer = {}) {
+  if (data.size() <= kRadixSortInsertionThreshold) {
+    return radixSortReduceBy(data, std::span<R>{}, key, reduce, observer);
+  }
+  observer.onAllocate(data.size() * sizeof(R));
+  std::vector<R> buffer(data.size());
+  return radixSortReduceBy(data, std::span<R>{buffer}, key, reduce, observer);
+}
+
+/**
+ * @brief Sorts arr and erases its duplicates; radix sorted for integer and
+ *        floating-point elements
+ */
+template <Pivotable T, SortObserver Observer = NullSortObserver>
+void sortUnique(std::vector<T>& arr, Observer observer = {}) {
+  std::size_t size = 0;
+  if constexpr (RadixSortable<T>) {
+    size = radixSortReduceBy(std::span<T>{arr}, std::identity{}, KeepFirst{}, observer);
+  } else {
+    size = static_cast<std::size_t>(
+        sortUnique(arr.begin(), arr.end(), std::less<>{}, std::identity{}, observer) -
+        arr.begin());
+  }
+  arr.erase(arr.begin() + static_cast<std::ptrdiff_t>(size), arr.end());
+}
+
+/**
+ * @brief The distinct elements of range in sorted order, each paired with
+ *        how many times it occurs
+ *
+ * Counting happens during the sort: (value, 1) pairs are built in one pass
+ * and then sorted with equal values folded together by adding their counts,
+ * radix sorted when the projected values are integers or floating point under
+ * the natural order and merge sorted otherwise. The range is left untouched.
+ */
+template <std::ranges::random_access_range R, typename Compare = std::ranges::less,
+          typename Proj = std::identity>
+  requires std::indirect_strict_weak_order<Compare,
+                                           std::projected<std::ranges::iterator_t<R>, Proj>> &&
+           std::copyable<std::ranges::range_value_t<R>>
+std::vector<std::pair<std::ranges::range_value_t<R>, std::size_t>> sortCount(R&& range,
+                                                                            Compare comp = {},
+                                                                            Proj proj = {}) {
+  using Value = std::ranges::range_value_t<R>;
+  using Counted = std::pair<Value, std::size_t>;
+  std::vector<Counted> counted;
+  counted.reserve(static_cast<std::size_t>(std::ranges::distance(range)));
+  for (const auto& value : range) {
+    counted.emplace_back(value, 1);
+  }
+  auto addCounts = [](Counted& kept, Counted&& next) { kept.second += next.second; };
+  auto keyOf = [&proj](const Counted& entry) -> decltype(auto) {
+    return std::invoke(proj, entry.first);
+  };
+  using Projected = std::remove_cvref_t<std::indirect_result_t<Proj&, std::ranges::iterator_t<R>>>;
+  std::size_t size = 0;
+  if constexpr (RadixSortable<Projected> && NaturalOrder<Compare, Projected> &&
+                std::default_initializable<Value>) {
+    size = radixSortReduceBy(std::span<Counted>{counted},
+                             [&keyOf](const Counted& entry) { return Projected(keyOf(entry)); },
+                             addCounts);
+  } else {
+    size = static_cast<std::size_t>(
+        sortReduce(counted.begin(), counted.end(), addCounts, comp, keyOf) - counted.begin());
+  }
+  counted.erase(counted.begin() + static_cast<std::ptrdiff_t>(size), counted.end());
+  return counted;
+}
+
+#endif  // AGGREGATE_SORT_HPP
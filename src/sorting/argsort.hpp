@@ -0,0 +1,135 @@
+#ifndef ARGSORT_HPP
+#define ARGSORT_HPP
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "merge_sort.hpp"
+#include "radix_sort.hpp"
+#include "sorting_concepts.hpp"
+#include "sorting_network.hpp"
+
+/**
+ * @brief Stable argsort: the permutation that sorts keys by comp applied to
+ *        proj of each key
+ *
+ * keys[result[0]], keys[result[1]], ... is sorted, and equal keys keep their
+ * original relative order. Keys whose projection is an integer or IEEE float
+ * under the natural order are radix sorted as (key, index) pairs, so the keys
+ * are read once per pass sequentially instead of through the indices; -0.0
+ * is paired as 0.0 there to stay equal to it. Other keys merge sort the
+ * indices.
+ *
+ * @tparam Index Unsigned index type of the permutation
+ * @throws std::invalid_argument if Index cannot address every key
+ */
+template <std::unsigned_integral Index = std::uint32_t, std::ranges::random_access_range Keys,
+          typename Compare = std::ranges::less, typename Proj = std::identity>
+  requires std::indirect_strict_weak_order<
+      Compare, std::projected<std::ranges::iterator_t<const Keys>, Proj>>
+std::vector<Index> argsort(const Keys& keys, Compare comp = {}, Proj proj = {}) {
+  auto first = std::ranges::begin(keys);
+  auto n = static_cast<std::size_t>(std::ranges::distance(keys));
+  if (n > 0 && n - 1 > std::numeric_limits<Index>::max()) {
+    throw std::invalid_argument("argsort index type is too narrow for the input");
+  }
+
+  using Projected = std::remove_cvref_t<
+      std::indirect_result_t<Proj&, std::ranges::iterator_t<const Keys>>>;
+  if constexpr (RadixSortable<Projected> && NaturalOrder<Compare, Projected>) {
+    struct KeyIndex {
+      Projected key;
+      Index index;
+    };
+    std::vector<KeyIndex> pairs(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      pairs[i] = {std::invoke(proj, first[i]), static_cast<Index>(i)};
+      if constexpr (std::floating_point<Projected>) {
+        // Radix sort orders -0.0 before 0.0, but < treats them as equal keys.
+        if (pairs[i].key == Projected{}) {
+          pairs[i].key = Projected{};
+        }
+      }
+    }
+    std::vector<KeyIndex> buffer(n);
+    radixSortBy(std::span<KeyIndex>{pairs}, std::span<KeyIndex>{buffer}, &KeyIndex::key);
+    std::vector<Index> order(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      order[i] = pairs[i].index;
+    }
+    return order;
+  } else {
+    std::vector<Index> order(n);
+    std::iota(order.begin(), order.end(), Index{0});
+    auto keyOf = [&](Index i) -> decltype(auto) { return std::invoke(proj, first[i]); };
+    mergeSort(order.begin(), order.end(), comp, keyOf);
+    return order;
+  }
+}
+
+/**
+ * @brief Reorders column so that its i-th element becomes column[order[i]]
+ *
+ * Gathers through one scratch copy of the column, so each element is moved
+ * twice and no element is compared.
+ *
+ * @throws std::invalid_argument if order and column differ in size
+ */
+template <std::ranges::random_access_range Order, std::ranges::random_access_range Column>
+  requires std::unsigned_integral<std::ranges::range_value_t<Order>> &&
+           std::movable<std::ranges::range_value_t<Column>>
+void applyPermutation(const Order& order, Column&& column) {
+  auto n = std::ranges::distance(column);
+  if (std::ranges::distance(order) != n) {
+    throw std::invalid_argument("applyPermutation order and column differ in size");
+  }
+  using Difference = std::ranges::range_difference_t<Column>;
+  auto first = std::ranges::begin(column);
+  std::vector<std::ranges::range_value_t<Column>> gathered;
+  gathered.reserve(static_cast<std::size_t>(n));
+  for (auto index : order) {
+    gathered.push_back(std::move(first[static_cast<Difference>(index)]));
+  }
+  std::ranges::move(gathered, first);
+}
+
+/**
+ * @brief Sorts the structure-of-arrays table formed by keys and columns by
+ *        keys, moving each row of every column along with its key
+ *
+ * The permutation is computed once with argsort and then applied to every
+ * column in turn, so rows are never gathered into a temporary struct. The
+ * sort is stable.
+ *
+ * @throws std::invalid_argument if a column differs in size from keys
+ */
+template <std::ranges::random_access_range Keys, std::ranges::random_access_range... Columns>
+  requires std::sortable<std::ranges::iterator_t<Keys>>
+void coSort(Keys&& keys, Columns&&... columns) {
+  auto n = std::ranges::distance(keys);
+  if (((std::ranges::distance(columns) != n) || ...)) {
+    throw std::invalid_argument("coSort columns differ in size from the keys");
+  }
+  auto reorder = [&](const auto& order) {
+    applyPermutation(order, keys);
+    (applyPermutation(order, columns), ...);
+  };
+  if (static_cast<std::uint64_t>(n) <= std::uint64_t{std::numeric_limits<std::uint32_t>::max()}) {
+    reorder(argsort<std::uint32_t>(keys));
+  } else {
+    reorder(argsort<std::uint64_t>(keys));
+  }
+}
+
+#endif  // ARGSORT_HPP
@@ -3,23 +3,42 @@
 
 #include <algorithm>
 #include <concepts>
-#include <iostream>
+#include <functional>
+#include <iterator>
+#include <ranges>
 #include <vector>
 #include <version>
 
+#include "sort_observer.hpp"
 #include "sorting_concepts.hpp"
 
-template <Sortable T>
-void bubbleSort(std::vector<T>& arr) {
-  std::cout << "Sorting " << arr.size() << " elements\n";
-  for (size_t i = 0; i < arr.size(); ++i) {
-    for (size_t j = 1; j < arr.size() - i; ++j) {
-      if (arr[j - 1] > arr[j]) {
-        std::cout << "Swapping " << arr[j - 1] << " and " << arr[j] << '\n';
-        std::swap(arr[j - 1], arr[j]);
+template <std::random_access_iterator It, typename Compare = std::ranges::less,
+          typename Proj = std::identity, SortObserver Observer = NullSortObserver>
+  requires SortableIterator<It, Compare, Proj>
+void bubbleSort(It first, It last, Compare comp = {}, Proj proj = {}, Observer observer = {}) {
+  auto less = observeComparisons(projectedComparator(comp, proj), observer);
+  auto n = last - first;
+  for (decltype(n) i = 0; i < n; ++i) {
+    for (decltype(n) j = 1; j < n - i; ++j) {
+      if (less(first[j], first[j - 1])) {
+        observer.onSwap();
+        std::iter_swap(first + (j - 1), first + j);
       }
     }
   }
 }
 
-#endif  // BUBBLE_SORT_HPP
\ No newline at end of file
+template <std::ranges::random_access_range R, typename Compare = std::ranges::less,
+          typename Proj = std::identity, SortObserver Observer = NullSortObserver>
+  requires SortableRange<R, Compare, Proj>
+void bubbleSort(R&& range, Compare comp = {}, Proj proj = {}, Observer observer = {}) {
+  auto first = std::ranges::begin(range);
+  bubbleSort(first, std::ranges::next(first, std::ranges::end(range)), comp, proj, observer);
+}
+
+template <Sortable T, SortObserver Observer = NullSortObserver>
+void bubbleSort(std::vector<T>& arr, Observer observer = {}) {
+  bubbleSort(arr.begin(), arr.end(), std::less<>{}, std::identity{}, observer);
+}
+
+#endif  // BUBBLE_SORT_HPP
@@ -0,0 +1,499 @@
+#ifndef EXTERNAL_SORT_HPP
+#define EXTERNAL_SORT_HPP
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <memory>
+#include <queue>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "merge_sort.hpp"
+#include "sorting_concepts.hpp"
+
+/**
+ * @brief Counters reported while an external sort runs and returned when it ends
+ */
+struct ExternalSortProgress {
+  std::uint64_t bytesRead = 0;     // Input and run-file bytes consumed so far
+  std::uint64_t bytesWritten = 0;  // Run-file and output bytes produced so far
+  std::size_t runs = 0;            // Sorted runs formed from the input
+  std::size_t mergePasses = 0;     // Merge passes completed, including the final one
+  std::chrono::duration<double> elapsed{};
+
+  // Combined read and write throughput in bytes per second
+  [[nodiscard]] double throughput() const {
+    double seconds = elapsed.count();
+    return seconds > 0 ? static_cast<double>(bytesRead + bytesWritten) / seconds : 0.0;
+  }
+};
+
+/**
+ * @brief Tuning knobs of externalSort
+ */
+struct ExternalSortOptions {
+  // Bytes of RAM the sort may use for records and I/O buffers
+  std::size_t memoryBudget = std::size_t{256} << 20;
+  // Preferred size of each sequential read or write during merging
+  std::size_t ioBlockBytes = std::size_t{4} << 20;
+  // Threads used by the in-memory run sorter; 0 uses the hardware concurrency
+  std::size_t threads = 1;
+  // Directory for spilled runs; empty selects the system temporary directory
+  std::filesystem::path tempDirectory;
+  // Invoked after every run is formed and after every merged block
+  std::function<void(const ExternalSortProgress&)> onProgress;
+};
+
+/**
+ * @brief Read-only or read-write memory mapping of a whole file (POSIX)
+ */
+class MappedFile {
+ public:
+  // Maps an existing file for reading
+  static MappedFile openRead(const std::filesystem::path& path) {
+    MappedFile file;
+    file.fd_ = ::open(path.c_str(), O_RDONLY);
+    if (file.fd_ < 0) {
+      throw std::system_error(errno, std::generic_category(), "open " + path.string());
+    }
+    struct stat info {};
+    if (::fstat(file.fd_, &info) != 0) {
+      throw std::system_error(errno, std::generic_category(), "fstat " + path.string());
+    }
+    file.map(static_cast<std::size_t>(info.st_size), PROT_READ);
+    if (file.size_ > 0) {
+      ::madvise(file.data_, file.size_, MADV_SEQUENTIAL);
+    }
+    return file;
+  }
+
+  // Creates or truncates a file of the given size and maps it for writing
+  static MappedFile create(const std::filesystem::path& path, std::size_t size) {
+    MappedFile file;
+    file.fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (file.fd_ < 0) {
+      throw std::system_error(errno, std::generic_category(), "open " + path.string());
+    }
+    if (::ftruncate(file.fd_, static_cast<off_t>(size)) != 0) {
+      throw std::system_error(errno, std::generic_category(), "ftruncate " + path.string());
+    }
+    file.map(size, PROT_READ | PROT_WRITE);
+    return file;
+  }
+
+  MappedFile(MappedFile&& other) noexcept
+      : fd_(std::exchange(other.fd_, -1)),
+        data_(std::exchange(other.data_, nullptr)),
+        size_(std::exchange(other.size_, 0)) {}
+  MappedFile& operator=(MappedFile&&) = delete;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  ~MappedFile() {
+    if (data_ != nullptr) {
+      ::munmap(data_, size_);
+    }
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+  }
+
+  [[nodiscard]] std::span<std::byte> bytes() const {
+    return {static_cast<std::byte*>(data_), size_};
+  }
+
+ private:
+  MappedFile() = default;
+
+  void map(std::size_t size, int protection) {
+    size_ = size;
+    if (size_ == 0) {
+      return;
+    }
+    void* data = ::mmap(nullptr, size_, protection, MAP_SHARED, fd_, 0);
+    if (data == MAP_FAILED) {
+      throw std::system_error(errno, std::generic_category(), "mmap");
+    }
+    data_ = data;
+  }
+
+  int fd_ = -1;
+  void* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+/**
+ * @brief Sequential reader of a spilled run with double-buffered prefetching
+ *
+ * While the merge consumes one block, the next one is read on a background
+ * task into the second buffer.
+ */
+template <typename T>
+class RunReader {
+ public:
+  RunReader(const std::filesystem::path& path, std::size_t records, std::size_t blockRecords,
+            std::atomic<std::uint64_t>& bytesRead)
+      : in_(path, std::ios::binary),
+        blockRecords_(blockRecords),
+        remaining_(records),
+        bytesRead_(bytesRead) {
+    if (!in_) {
+      throw std::runtime_error("Cannot open run file " + path.string());
+    }
+    fill(front_);
+    prefetch();
+  }
+
+  RunReader(const RunReader&) = delete;
+  RunReader& operator=(const RunReader&) = delete;
+
+  ~RunReader() {
+    if (pending_.valid()) {
+      pending_.wait();
+    }
+  }
+
+  [[nodiscard]] bool empty() const { return pos_ == front_.size(); }
+  [[nodiscard]] const T& front() const { return front_[pos_]; }
+
+  void pop() {
+    if (++pos_ < front_.size() || !pending_.valid()) {
+      return;
+    }
+    pending_.get();
+    std::swap(front_, back_);
+    pos_ = 0;
+    prefetch();
+  }
+
+ private:
+  void fill(std::vector<T>& block) {
+    block.resize(std::min(blockRecords_, remaining_));
+    std::size_t bytes = block.size() * sizeof(T);
+    if (!in_.read(reinterpret_cast<char*>(block.data()), static_cast<std::streamsize>(bytes))) {
+      throw std::runtime_error("Short read from run file");
+    }
+    remaining_ -= block.size();
+    bytesRead_.fetch_add(bytes, std::memory_order_relaxed);
+  }
+
+  void prefetch() {
+    if (remaining_ > 0) {
+      pending_ = std::async(std::launch::async, [this] { fill(back_); });
+    }
+  }
+
+  std::ifstream in_;
+  std::size_t blockRecords_;
+  std::vector<T> front_;
+  std::vector<T> back_;
+  std::size_t pos_ = 0;
+  std::size_t remaining_;
+  std::future<void> pending_;
+  std::atomic<std::uint64_t>& bytesRead_;
+};
+
+/**
+ * @brief Sequential writer of a run file with double-buffered background writes
+ */
+template <typename T>
+class RunWriter {
+ public:
+  RunWriter(const std::filesystem::path& path, std::size_t blockRecords,
+            std::atomic<std::uint64_t>& bytesWritten)
+      : out_(path, std::ios::binary | std::ios::trunc),
+        blockRecords_(blockRecords),
+        bytesWritten_(bytesWritten) {
+    if (!out_) {
+      throw std::runtime_error("Cannot create run file " + path.string());
+    }
+    active_.reserve(blockRecords_);
+    flushing_.reserve(blockRecords_);
+  }
+
+  RunWriter(const RunWriter&) = delete;
+  RunWriter& operator=(const RunWriter&) = delete;
+
+  ~RunWriter() {
+    if (pending_.valid()) {
+      pending_.wait();
+    }
+  }
+
+  void push(const T& record) {
+    active_.push_back(record);
+    if (active_.size() == blockRecords_) {
+      flush();
+    }
+  }
+
+  // Writes out buffered records and waits for all writes to complete
+  void finish() {
+    flush();
+    if (pending_.valid()) {
+      pending_.get();
+    }
+    out_.flush();
+    if (!out_) {
+      throw std::runtime_error("Failed to write run file");
+    }
+  }
+
+ private:
+  void flush() {
+    if (pending_.valid()) {
+      pending_.get();
+    }
+    std::swap(active_, flushing_);
+    active_.clear();
+    if (flushing_.empty()) {
+      return;
+    }
+    pending_ = std::async(std::launch::async, [this] {
+      std::size_t bytes = flushing_.size() * sizeof(T);
+      out_.write(reinterpret_cast<const char*>(flushing_.data()),
+                 static_cast<std::streamsize>(bytes));
+      bytesWritten_.fetch_add(bytes, std::memory_order_relaxed);
+    });
+  }
+
+  std::ofstream out_;
+  std::size_t blockRecords_;
+  std::vector<T> active_;
+  std::vector<T> flushing_;
+  std::future<void> pending_;
+  std::atomic<std::uint64_t>& bytesWritten_;
+};
+
+/**
+ * @brief Stable k-way merge of run readers into sink using a binary heap
+ *
+ * Ties between runs are resolved by run order, which keeps the sort stable.
+ */
+template <typename T, typename Compare, typename Sink>
+void mergeRunReaders(std::vector<std::unique_ptr<RunReader<T>>>& readers, Compare comp,
+                     Sink&& sink) {
+  auto after = [&](std::size_t a, std::size_t b) {
+    const T& x = readers[a]->front();
+    const T& y = readers[b]->front();
+    return comp(y, x) || (!comp(x, y) && a > b);
+  };
+  std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(after)> heap(after);
+  for (std::size_t i = 0; i < readers.size(); ++i) {
+    if (!readers[i]->empty()) {
+      heap.push(i);
+    }
+  }
+  while (!heap.empty()) {
+    std::size_t run = heap.top();
+    heap.pop();
+    sink(readers[run]->front());
+    readers[run]->pop();
+    if (!readers[run]->empty()) {
+      heap.push(run);
+    }
+  }
+}
+
+/**
+ * @brief Sorts a file of fixed-width records that may be larger than RAM
+ *
+ * The input is memory-mapped and cut into chunks that fit half the memory
+ * budget. Each chunk is sorted with parallelMergeSort (the other half is its
+ * scratch) and spilled to a temporary run file; a single chunk is written
+ * straight to the output. Runs are then k-way merged with large sequential,
+ * double-buffered reads and writes. When there are more runs than the budget
+ * can buffer, intermediate passes merge groups of them first. The final pass
+ * writes into the memory-mapped output file. The sort is stable.
+ *
+ * Records are the raw bytes of T, so T must be trivially copyable and the
+ * input size must be a multiple of sizeof(T). T must also be default
+ * constructible, since the chunk and I/O buffers are sized up front.
+ *
+ * @param input Path of the file to sort
+ * @param output Path of the sorted file to create (must differ from input)
+ * @param options Memory budget, I/O block size, threads and progress callback
+ * @param comp Strict weak ordering of the records
+ * @return Final I/O counters of the sort
+ * @throws std::invalid_argument if input and output are the same file, the
+ *         input size is not a multiple of sizeof(T) or the memory budget cannot
+ *         hold two records per buffer
+ * @throws std::system_error or std::runtime_error on I/O failures
+ */
+template <Mergeable T, typename Compare = std::less<>>
+  requires std::is_trivially_copyable_v<T> && std::default_initializable<T>
+ExternalSortProgress externalSort(const std::filesystem::path& input,
+                                  const std::filesystem::path& output,
+                                  const ExternalSortOptions& options = {}, Compare comp = {}) {
+  auto start = std::chrono::steady_clock::now();
+  std::atomic<std::uint64_t> bytesRead{0};
+  std::atomic<std::uint64_t> bytesWritten{0};
+  ExternalSortProgress progress;
+  auto report = [&] {
+    progress.bytesRead = bytesRead.load(std::memory_order_relaxed);
+    progress.bytesWritten = bytesWritten.load(std::memory_order_relaxed);
+    progress.elapsed = std::chrono::steady_clock::now() - start;
+    if (options.onProgress) {
+      options.onProgress(progress);
+    }
+  };
+
+  std::error_code ignored;
+  if (std::filesystem::equivalent(input, output, ignored)) {
+    throw std::invalid_argument("externalSort cannot sort a file onto itself");
+  }
+  MappedFile source = MappedFile::openRead(input);
+  std::span<const std::byte> inputBytes = source.bytes();
+  if (inputBytes.size() % sizeof(T) != 0) {
+    throw std::invalid_argument("externalSort input size is not a multiple of the record size");
+  }
+  std::size_t records = inputBytes.size() / sizeof(T);
+  std::size_t chunkRecords = options.memoryBudget / (2 * sizeof(T));
+  if (chunkRecords < 2) {
+    throw std::invalid_argument("externalSort memory budget is too small for the record size");
+  }
+  chunkRecords = std::min(chunkRecords, std::max<std::size_t>(records, 1));
+
+  MappedFile target = MappedFile::create(output, inputBytes.size());
+  auto* out = reinterpret_cast<T*>(target.bytes().data());
+  if (records == 0) {
+    report();
+    return progress;
+  }
+
+  // Run formation: sort memory-sized chunks, spill them unless there is only one.
+  std::vector<T> chunk(chunkRecords);
+  std::vector<T> scratch(chunkRecords);
+  auto sortChunk = [&](std::size_t first, std::size_t count) {
+    std::memcpy(chunk.data(), inputBytes.data() + first * sizeof(T), count * sizeof(T));
+    bytesRead.fetch_add(count * sizeof(T), std::memory_order_relaxed);
+    parallelMergeSort(chunk.begin(), chunk.begin() + static_cast<std::ptrdiff_t>(count),
+                      scratch.begin(), comp, options.threads);
+  };
+  if (records <= chunkRecords) {
+    sortChunk(0, records);
+    std::memcpy(out, chunk.data(), records * sizeof(T));
+    bytesWritten.fetch_add(records * sizeof(T), std::memory_order_relaxed);
+    progress.runs = 1;
+    report();
+    return progress;
+  }
+
+  std::filesystem::path tempDirectory = options.tempDirectory.empty()
+                                            ? std::filesystem::temp_directory_path()
+                                            : options.tempDirectory;
+  std::string prefix = "clavis-run-" + std::to_string(std::random_device{}()) + "-";
+  std::size_t nextRunId = 0;
+  struct Run {
+    std::filesystem::path path;
+    std::size_t records;
+  };
+  struct RunFiles {
+    std::vector<Run> runs;
+    ~RunFiles() {
+      for (const Run& run : runs) {
+        std::error_code ignored;
+        std::filesystem::remove(run.path, ignored);
+      }
+    }
+  } files;
+  auto newRunPath = [&] { return tempDirectory / (prefix + std::to_string(nextRunId++)); };
+
+  for (std::size_t first = 0; first < records; first += chunkRecords) {
+    std::size_t count = std::min(chunkRecords, records - first);
+    sortChunk(first, count);
+    Run run{newRunPath(), count};
+    std::ofstream spill(run.path, std::ios::binary | std::ios::trunc);
+    spill.write(reinterpret_cast<const char*>(chunk.data()),
+                static_cast<std::streamsize>(count * sizeof(T)));
+    if (!spill.flush()) {
+      throw std::runtime_error("Failed to write run file " + run.path.string());
+    }
+    bytesWritten.fetch_add(count * sizeof(T), std::memory_order_relaxed);
+    files.runs.push_back(std::move(run));
+    ++progress.runs;
+    report();
+  }
+  chunk = {};
+  scratch = {};
+
+  // Each merged run needs two read buffers; the output needs two more.
+  std::size_t blockBytes = std::max(options.ioBlockBytes, sizeof(T));
+  std::size_t fanIn = std::max<std::size_t>(options.memoryBudget / (2 * blockBytes), 3) - 1;
+  auto blockRecordsFor = [&](std::size_t ways) {
+    std::size_t bytes = std::min(blockBytes, options.memoryBudget / (2 * (ways + 1)));
+    return std::max<std::size_t>(bytes / sizeof(T), 1);
+  };
+  auto openReaders = [&](std::span<const Run> group, std::size_t blockRecords) {
+    std::vector<std::unique_ptr<RunReader<T>>> readers;
+    for (const Run& run : group) {
+      readers.push_back(
+          std::make_unique<RunReader<T>>(run.path, run.records, blockRecords, bytesRead));
+    }
+    return readers;
+  };
+
+  // Intermediate passes until the remaining runs fit in one merge.
+  while (files.runs.size() > fanIn) {
+    RunFiles merged;
+    for (std::size_t first = 0; first < files.runs.size(); first += fanIn) {
+      std::size_t ways = std::min(fanIn, files.runs.size() - first);
+      std::span<const Run> group(files.runs.data() + first, ways);
+      Run run{newRunPath(), 0};
+      for (const Run& part : group) {
+        run.records += part.records;
+      }
+      std::size_t blockRecords = blockRecordsFor(ways);
+      {
+        auto readers = openReaders(group, blockRecords);
+        RunWriter<T> writer(run.path, blockRecords, bytesWritten);
+        merged.runs.push_back(run);
+        mergeRunReaders(readers, comp, [&](const T& record) { writer.push(record); });
+        writer.finish();
+      }
+      report();
+    }
+    // The previous generation of runs is deleted when merged goes out of scope.
+    std::swap(files.runs, merged.runs);
+    ++progress.mergePasses;
+  }
+
+  // Final pass straight into the mapped output.
+  std::size_t blockRecords = blockRecordsFor(files.runs.size());
+  auto readers = openReaders(files.runs, blockRecords);
+  std::size_t written = 0;
+  mergeRunReaders(readers, comp, [&](const T& record) {
+    out[written++] = record;
+    if (written % blockRecords == 0) {
+      bytesWritten.fetch_add(blockRecords * sizeof(T), std::memory_order_relaxed);
+      report();
+    }
+  });
+  bytesWritten.fetch_add((written % blockRecords) * sizeof(T), std::memory_order_relaxed);
+  ++progress.mergePasses;
+  report();
+  return progress;
+}
+
+#endif  // EXTERNAL_SORT_HPP
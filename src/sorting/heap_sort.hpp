@@ -1,43 +1,183 @@
 #ifndef HEAP_SORT_HPP
 #define HEAP_SORT_HPP
 
+#include <algorithm>
 #include <concepts>
-#include <iostream>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
 #include <ranges>
+#include <utility>
 #include <vector>
 
+#include "sort_observer.hpp"
 #include "sorting_concepts.hpp"
 
-template <Heapable T>
-void heapify(std::vector<T>& arr, size_t n, size_t i) {
-  std::cout << "Heapify at index " << i << " with size " << n << '\n';
-  size_t largest = i;
-  size_t left = 2 * i + 1;
-  size_t right = 2 * i + 2;
+#if defined(__GNUC__) || defined(__clang__)
+#define CLAVIS_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define CLAVIS_PREFETCH(address) static_cast<void>(address)
+#endif
 
-  if (left < n && arr[left] > arr[largest]) {
-    largest = left;
+// Children per node of the heap that heapSort builds. Wider heaps are
+// shallower but compare more per level, which only pays off when a cache
+// miss costs more than the extra comparisons; see dAryHeapSort.
+inline constexpr std::ptrdiff_t kHeapSortArity = 2;
+
+/**
+ * @brief Prefetches the grandchildren below the children starting at child,
+ *        which the sift visits next, while it is still choosing among the
+ *        children
+ *
+ * Only for heaps of four or more children per node: binary grandchildren sit
+ * next to their parents in memory and are fetched with them anyway.
+ */
+template <std::ptrdiff_t Arity, std::random_access_iterator It>
+void prefetchHeapGrandchildren(It first, std::iter_difference_t<It> n,
+                               std::iter_difference_t<It> child) {
+  if constexpr (Arity >= 4 && std::contiguous_iterator<It>) {
+    auto grandchild = Arity * child + 1;
+    if (grandchild < n) {
+      CLAVIS_PREFETCH(std::to_address(first + grandchild));
+      CLAVIS_PREFETCH(std::to_address(first + std::min(grandchild + Arity * Arity, n) - 1));
+    }
+  }
+}
+
+/**
+ * @brief Floyd's bottom-up sift: fills the hole at index hole of the n-element
+ *        Arity-ary max-heap rooted at first with value
+ *
+ * Walks the hole down to a leaf along the largest children without comparing
+ * against value, then moves value back up from there. Values taken from the
+ * bottom of the heap, as in the sortdown phase, belong near the leaves, so
+ * this takes Arity - 1 comparisons per level plus a short climb instead of
+ * Arity per level, and moves elements through the hole instead of swapping.
+ * The largest child is picked with selects rather than branches, since which
+ * child wins is unpredictable.
+ */
+template <std::ptrdiff_t Arity, std::random_access_iterator It, typename Compare,
+          SortObserver Observer = NullSortObserver>
+void siftDownBottomUp(It first, std::iter_difference_t<It> n, std::iter_difference_t<It> hole,
+                      std::iter_value_t<It> value, Compare comp, Observer observer = {}) {
+  auto top = hole;
+  std::size_t moves = 1;
+  for (auto child = Arity * hole + 1; child + Arity <= n; child = Arity * hole + 1) {
+    prefetchHeapGrandchildren<Arity>(first, n, child);
+    auto largest = child;
+    for (std::ptrdiff_t k = 1; k < Arity; ++k) {
+      largest = comp(first[largest], first[child + k]) ? child + k : largest;
+    }
+    first[hole] = std::move(first[largest]);
+    hole = largest;
+    ++moves;
   }
-  if (right < n && arr[right] > arr[largest]) {
-    largest = right;
+  // At most one node has fewer than Arity children.
+  if (auto child = Arity * hole + 1; child < n) {
+    auto largest = child;
+    for (auto sibling = child + 1; sibling < n; ++sibling) {
+      largest = comp(first[largest], first[sibling]) ? sibling : largest;
+    }
+    first[hole] = std::move(first[largest]);
+    hole = largest;
+    ++moves;
   }
-  if (largest != i) {
-    std::cout << "Swapping elements at " << i << " and " << largest << '\n';
-    std::swap(arr[i], arr[largest]);
-    heapify(arr, n, largest);
+  while (hole > top) {
+    auto parent = (hole - 1) / Arity;
+    if (!comp(first[parent], value)) {
+      break;
+    }
+    first[hole] = std::move(first[parent]);
+    hole = parent;
+    ++moves;
   }
+  first[hole] = std::move(value);
+  observer.onMove(moves);
 }
 
-template <Heapable T>
-void heapSort(std::vector<T>& arr) {
-  std::cout << "Starting heapSort with array size: " << arr.size() << '\n';
-  for (int i = arr.size() / 2 - 1; i >= 0; --i) {
-    heapify(arr, arr.size(), i);
+template <Heapable T, SortObserver Observer = NullSortObserver>
+void heapify(std::vector<T>& arr, size_t n, size_t i, Observer observer = {}) {
+  auto value = std::move(arr[i]);
+  siftDownBottomUp<2>(arr.begin(), static_cast<std::ptrdiff_t>(n), static_cast<std::ptrdiff_t>(i),
+                      std::move(value), observeComparisons(std::less<>{}, observer), observer);
+}
+
+/**
+ * @brief Iterative heap sort over [first, last) on an Arity-ary heap
+ *
+ * Worst-case O(n log n) with O(1) extra space; introsort falls back to it when
+ * quicksort recursion gets too deep. Both phases use siftDownBottomUp.
+ * Comparisons are not reported, so callers pass an already observed
+ * comparator.
+ */
+template <std::ptrdiff_t Arity = kHeapSortArity, std::random_access_iterator It,
+          typename Compare, SortObserver Observer = NullSortObserver>
+  requires(Arity >= 2)
+void heapSortImpl(It first, It last, Compare comp, Observer observer = {}) {
+  auto n = last - first;
+  for (auto i = (n + Arity - 2) / Arity; i > 0; --i) {
+    auto value = std::move(first[i - 1]);
+    siftDownBottomUp<Arity>(first, n, i - 1, std::move(value), comp, observer);
   }
-  for (int i = arr.size() - 1; i > 0; --i) {
-    std::swap(arr[0], arr[i]);
-    heapify(arr, i, 0);
+  for (auto end = n - 1; end > 0; --end) {
+    observer.onSwap();
+    auto value = std::move(first[end]);
+    first[end] = std::move(first[0]);
+    siftDownBottomUp<Arity>(first, end, decltype(n){0}, std::move(value), comp, observer);
   }
 }
 
-#endif  // HEAP_SORT_HPP
\ No newline at end of file
+/**
+ * @brief Heap sort of [first, last) by comp applied to proj of each element
+ *        on a heap with Arity children per node
+ *
+ * A 4-ary or 8-ary heap is half or a third as deep as the binary one that
+ * heapSort uses, each node's children are adjacent so choosing among them
+ * touches one or two cache lines, and the grandchildren are prefetched while
+ * the children are compared. That costs more comparisons per level, so it
+ * pays off for inputs far larger than the cache or for elements whose
+ * comparisons chase pointers, such as strings; for small arithmetic keys the
+ * binary heap is faster.
+ */
+template <std::ptrdiff_t Arity, std::random_access_iterator It,
+          typename Compare = std::ranges::less, typename Proj = std::identity,
+          SortObserver Observer = NullSortObserver>
+  requires SortableIterator<It, Compare, Proj> && (Arity >= 2)
+void dAryHeapSort(It first, It last, Compare comp = {}, Proj proj = {}, Observer observer = {}) {
+  heapSortImpl<Arity>(first, last, observeComparisons(projectedComparator(comp, proj), observer),
+                      observer);
+}
+
+template <std::ptrdiff_t Arity, std::ranges::random_access_range R,
+          typename Compare = std::ranges::less, typename Proj = std::identity,
+          SortObserver Observer = NullSortObserver>
+  requires SortableRange<R, Compare, Proj> && (Arity >= 2)
+void dAryHeapSort(R&& range, Compare comp = {}, Proj proj = {}, Observer observer = {}) {
+  auto first = std::ranges::begin(range);
+  dAryHeapSort<Arity>(first, std::ranges::next(first, std::ranges::end(range)), comp, proj,
+                      observer);
+}
+
+template <std::random_access_iterator It, typename Compare = std::ranges::less,
+          typename Proj = std::identity, SortObserver Observer = NullSortObserver>
+  requires SortableIterator<It, Compare, Proj>
+void heapSort(It first, It last, Compare comp = {}, Proj proj = {}, Observer observer = {}) {
+  heapSortImpl(first, last, observeComparisons(projectedComparator(comp, proj), observer),
+               observer);
+}
+
+template <std::ranges::random_access_range R, typename Compare = std::ranges::less,
+          typename Proj = std::identity, SortObserver Observer = NullSortObserver>
+  requires SortableRange<R, Compare, Proj>
+void heapSort(R&& range, Compare comp = {}, Proj proj = {}, Observer observer = {}) {
+  auto first = std::ranges::begin(range);
+  heapSort(first, std::ranges::next(first, std::ranges::end(range)), comp, proj, observer);
+}
+
+template <Heapable T, SortObserver Observer = NullSortObserver>
+void heapSort(std::vector<T>& arr, Observer observer = {}) {
+  heapSort(arr.begin(), arr.end(), std::less<>{}, std::identity{}, observer);
+}
+
+#endif  // HEAP_SORT_HPP
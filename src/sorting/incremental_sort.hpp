@@ -0,0 +1,181 @@
+#ifndef INCREMENTAL_SORT_HPP
+#define INCREMENTAL_SORT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "quick_sort.hpp"
+#include "sorting_concepts.hpp"
+
+// Unsorted segments at or below this size are sorted outright instead of
+// being partitioned further.
+inline constexpr std::ptrdiff_t kIncrementalSortSegmentThreshold = 32;
+
+/**
+ * @brief Incremental quicksort of [first, last): hands out the elements in
+ *        sorted order on demand, partitioning only as far as needed
+ *
+ * Keeps a stack of pivot positions above the part already handed out; the
+ * elements between two of them are unsorted but lie between the two pivots.
+ * Producing the next element partitions the segment in front of it, pushing
+ * each pivot, until the segment is small enough to sort outright. Reading
+ * the first k of n elements costs O(n + k log k) expected comparisons, and
+ * reading all of them costs about as much as a quicksort. Batches ending
+ * beyond the top segment sort it whole, and the pivot stack shares the
+ * introsort depth budget with the driver that sorts finished segments, so
+ * adversarial inputs fall back to heap sort and stay O(n log n) overall.
+ *
+ * The sorter reorders the underlying range as it goes: after k elements have
+ * been handed out, the first k of the range hold them in sorted order. It is
+ * an input range over the elements not handed out yet, so a range-for over
+ * it can stop as soon as enough elements have been seen.
+ */
+template <std::random_access_iterator It, typename Compare>
+class IncrementalSort {
+ public:
+  class Iterator {
+   public:
+    using value_type = std::iter_value_t<It>;
+    using difference_type = std::ptrdiff_t;
+
+    Iterator() = default;
+    explicit Iterator(IncrementalSort* sorter) : sorter_(sorter) {}
+
+    std::iter_reference_t<It> operator*() const { return sorter_->peek(); }
+    Iterator& operator++() {
+      sorter_->next();
+      return *this;
+    }
+    void operator++(int) { ++*this; }
+    friend bool operator==(const Iterator& it, std::default_sentinel_t) {
+      return it.sorter_->done();
+    }
+
+   private:
+    IncrementalSort* sorter_ = nullptr;
+  };
+
+  IncrementalSort(It first, It last, Compare comp)
+      : first_(first),
+        size_(last - first),
+        depthLimit_(introSortDepthLimit(first, last)),
+        comp_(std::move(comp)) {
+    bounds_.push_back(size_);
+  }
+
+  // Whether every element has been handed out.
+  bool done() const { return position_ == size_; }
+
+  // Number of elements handed out so far.
+  std::size_t position() const { return static_cast<std::size_t>(position_); }
+
+  // Number of elements not handed out yet.
+  std::size_t remaining() const { return static_cast<std::size_t>(size_ - position_); }
+
+  /**
+   * @brief The next element in sorted order, without handing it out
+   * @throws std::out_of_range if every element has been handed out
+   */
+  std::iter_reference_t<It> peek() {
+    if (done()) {
+      throw std::out_of_range("IncrementalSort has no elements left");
+    }
+    settle(position_ + 1);
+    return first_[position_];
+  }
+
+  /**
+   * @brief Hands out the next element in sorted order
+   * @throws std::out_of_range if every element has been handed out
+   */
+  std::iter_reference_t<It> next() {
+    std::iter_reference_t<It> value = peek();
+    ++position_;
+    return value;
+  }
+
+  /**
+   * @brief Hands out the next count elements in sorted order, or all that
+   *        remain if fewer do
+   *
+   * Settling a batch at once partitions only down to segments that straddle
+   * its end and sorts the segments inside it whole, which is cheaper than
+   * fetching the same elements one by one.
+   */
+  std::ranges::subrange<It> nextBatch(std::size_t count) {
+    std::ptrdiff_t end = position_ + static_cast<std::ptrdiff_t>(std::min(count, remaining()));
+    settle(end);
+    auto batch = std::ranges::subrange<It>(first_ + position_, first_ + end);
+    position_ = end;
+    return batch;
+  }
+
+  Iterator begin() { return Iterator(this); }
+  std::default_sentinel_t end() const { return std::default_sentinel; }
+
+ private:
+  // Puts the elements before target into their final places.
+  void settle(std::ptrdiff_t target) {
+    while (settled_ < target) {
+      std::ptrdiff_t bound = bounds_.back();
+      It segmentFirst = first_ + settled_;
+      It segmentLast = first_ + bound;
+      if (bound <= target || bound - settled_ <= kIncrementalSortSegmentThreshold ||
+          static_cast<int>(bounds_.size()) > depthLimit_) {
+        // The segment inherits what is left of the depth budget, so a stack
+        // that is already too deep finishes it with heap sort.
+        int depth = static_cast<int>(bounds_.size()) - 1;
+        introSortLoop(segmentFirst, segmentLast, comp_, std::max(depthLimit_ - depth, 0));
+        // The bound itself is a pivot already in place, except for the end.
+        settled_ = bound == size_ ? bound : bound + 1;
+        bounds_.pop_back();
+        continue;
+      }
+      choosePivot(segmentFirst, segmentLast, comp_);
+      bounds_.push_back(partitionRange(segmentFirst, segmentLast, comp_) - first_);
+      if (bounds_.back() == settled_) {
+        // The pivot is the smallest element left and is final where it is.
+        bounds_.pop_back();
+        ++settled_;
+      }
+    }
+  }
+
+  It first_;
+  std::ptrdiff_t size_;
+  std::ptrdiff_t position_ = 0;
+  // End of the prefix whose elements are in their final places.
+  std::ptrdiff_t settled_ = 0;
+  // Pivot positions above settled_, innermost last, with size_ at the bottom.
+  std::vector<std::ptrdiff_t> bounds_;
+  int depthLimit_;
+  Compare comp_;
+};
+
+/**
+ * @brief Starts an incremental sort of [first, last) by comp applied to proj
+ *        of each element
+ */
+template <std::random_access_iterator It, typename Compare = std::ranges::less,
+          typename Proj = std::identity>
+  requires SortableIterator<It, Compare, Proj>
+auto incrementalSort(It first, It last, Compare comp = {}, Proj proj = {}) {
+  return IncrementalSort<It, decltype(projectedComparator(comp, proj))>(
+      first, last, projectedComparator(comp, proj));
+}
+
+template <std::ranges::random_access_range R, typename Compare = std::ranges::less,
+          typename Proj = std::identity>
+  requires SortableRange<R, Compare, Proj> && std::ranges::borrowed_range<R>
+auto incrementalSort(R&& range, Compare comp = {}, Proj proj = {}) {
+  auto first = std::ranges::begin(range);
+  return incrementalSort(first, std::ranges::next(first, std::ranges::end(range)), comp, proj);
+}
+
+#endif  // INCREMENTAL_SORT_HPP
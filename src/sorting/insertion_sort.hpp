@@ -0,0 +1,72 @@
+#ifndef INSERTION_SORT_HPP
+#define INSERTION_SORT_HPP
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+#include "sort_observer.hpp"
+#include "sorting_concepts.hpp"
+
+/**
+ * @brief Stable insertion sort over [first, last)
+ *
+ * Shifts larger elements right into a hole instead of swapping, so every
+ * element is moved at most once per step. Used as the small-range base case
+ * of the divide-and-conquer sorts, which count comparisons themselves.
+ *
+ * @param first Iterator to the first element
+ * @param last Iterator past the last element
+ * @param comp Strict weak ordering
+ * @param observer Notified of every element move
+ */
+template <std::random_access_iterator It, typename Compare,
+          SortObserver Observer = NullSortObserver>
+void insertionSortImpl(It first, It last, Compare comp, Observer observer = {}) {
+  if (first == last) {
+    return;
+  }
+  for (It i = std::next(first); i != last; ++i) {
+    if (!comp(*i, *std::prev(i))) {
+      continue;
+    }
+    auto value = std::move(*i);
+    It hole = i;
+    do {
+      *hole = std::move(*std::prev(hole));
+      --hole;
+    } while (hole != first && comp(value, *std::prev(hole)));
+    *hole = std::move(value);
+    observer.onMove(static_cast<std::size_t>(i - hole) + 2);
+  }
+}
+
+/**
+ * @brief Stable insertion sort of [first, last) by comp applied to proj of
+ *        each element, like std::ranges::sort
+ */
+template <std::random_access_iterator It, typename Compare = std::ranges::less,
+          typename Proj = std::identity, SortObserver Observer = NullSortObserver>
+  requires SortableIterator<It, Compare, Proj>
+void insertionSort(It first, It last, Compare comp = {}, Proj proj = {}, Observer observer = {}) {
+  insertionSortImpl(first, last, observeComparisons(projectedComparator(comp, proj), observer),
+                    observer);
+}
+
+template <std::ranges::random_access_range R, typename Compare = std::ranges::less,
+          typename Proj = std::identity, SortObserver Observer = NullSortObserver>
+  requires SortableRange<R, Compare, Proj>
+void insertionSort(R&& range, Compare comp = {}, Proj proj = {}, Observer observer = {}) {
+  auto first = std::ranges::begin(range);
+  insertionSort(first, std::ranges::next(first, std::ranges::end(range)), comp, proj, observer);
+}
+
+template <Pivotable T, SortObserver Observer = NullSortObserver>
+void insertionSort(std::vector<T>& arr, Observer observer = {}) {
+  insertionSort(arr.begin(), arr.end(), std::less<>{}, std::identity{}, observer);
+}
+
+#endif  // INSERTION_SORT_HPP
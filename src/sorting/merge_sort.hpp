@@ -3,54 +3,374 @@
 
 #include <algorithm>
 #include <concepts>
-#include <iostream>
-#include <memory>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory_resource>
+#include <ranges>
 #include <span>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
+#include "insertion_sort.hpp"
+#include "sort_observer.hpp"
+#include "sort_scratch.hpp"
 #include "sorting_concepts.hpp"
+#include "sorting_network.hpp"
+#include "sorting_parallel.hpp"
 
-template <Mergeable T>
-void merge(std::span<T> arr, size_t left, size_t mid, size_t right) {
-  std::cout << "Merging: left=" << left << " mid=" << mid << " right=" << right << '\n';
-  std::vector<T> temp(right - left + 1);
-  size_t i = left, j = mid + 1, k = 0;
-
-  while (i <= mid && j <= right) {
-    if (arr[i] <= arr[j]) {
-      temp[k++] = std::move(arr[i++]);
+// Length of the runs insertion sorted before the bottom-up merge passes.
+inline constexpr std::ptrdiff_t kMergeSortRunLength = 32;
+// Inputs at or below this size are not worth splitting across threads.
+inline constexpr std::ptrdiff_t kParallelMergeSortThreshold = std::ptrdiff_t{1} << 15;
+
+/**
+ * @brief Stable merge of the sorted runs [first1, last1) and [first2, last2) into out
+ *
+ * Ties are taken from the first run.
+ *
+ * @return Iterator past the last element written
+ */
+template <std::random_access_iterator In, std::random_access_iterator Out, typename Compare,
+          SortObserver Observer = NullSortObserver>
+Out mergeRuns(In first1, In last1, In first2, In last2, Out out, Compare comp,
+              Observer observer = {}) {
+  using T = std::iter_value_t<In>;
+  observer.onMove(static_cast<std::size_t>((last1 - first1) + (last2 - first2)));
+  // Equal integers are indistinguishable, so the unstable vector merge is safe for them.
+  if constexpr (std::contiguous_iterator<In> && std::contiguous_iterator<Out> &&
+                std::same_as<T, std::iter_value_t<Out>> && std::integral<T> &&
+                SortingNetworkKey<T> && NaturalOrder<Compare, T>) {
+#if CLAVIS_HAS_AVX2_KERNELS
+    if (sortingNetworkAvailable()) {
+      auto n1 = static_cast<std::size_t>(last1 - first1);
+      auto n2 = static_cast<std::size_t>(last2 - first2);
+      simdMergeRuns(std::to_address(first1), n1, std::to_address(first2), n2,
+                    std::to_address(out));
+      return out + static_cast<std::iter_difference_t<Out>>(n1 + n2);
+    }
+#endif
+  }
+  while (first1 != last1 && first2 != last2) {
+    if (comp(*first2, *first1)) {
+      *out++ = std::move(*first2++);
     } else {
-      temp[k++] = std::move(arr[j++]);
+      *out++ = std::move(*first1++);
     }
   }
-  /*
-   * Commented out because it causes errors in the CI environment.
-   ** std::ranges::move(arr.subspan(i, mid - i + 1), temp.begin() + k);
-   ** std::ranges::move(arr.subspan(j, right - j + 1), temp.begin() + k);
-   ** std::ranges::move(temp, arr.begin() + left);
-   */
-  std::move(arr.begin() + i, arr.begin() + i + (mid - i + 1), temp.begin() + k);
-  std::move(arr.begin() + j, arr.begin() + j + (right - j + 1), temp.begin() + k);
-  std::move(temp.begin(), temp.end(), arr.begin() + left);
+  out = std::move(first1, last1, out);
+  return std::move(first2, last2, out);
 }
 
-template <Mergeable T>
-void mergeSortImpl(std::span<T> arr, size_t left, size_t right) {
-  if (left >= arr.size() || right >= arr.size() || left >= right) {
+/**
+ * @brief Merges arr[left..mid] and arr[mid+1..right] in place
+ *
+ * Only the left run is moved out, so scratch needs mid - left + 1 elements.
+ *
+ * @throws std::invalid_argument if scratch is too small
+ */
+template <Mergeable T, SortObserver Observer = NullSortObserver>
+void merge(std::span<T> arr, size_t left, size_t mid, size_t right, std::span<T> scratch,
+           Observer observer = {}) {
+  size_t leftSize = mid - left + 1;
+  if (scratch.size() < leftSize) {
+    throw std::invalid_argument("merge scratch is smaller than the left run");
+  }
+  observer.onMove(leftSize + (right - left + 1));
+  auto buffered = std::move(arr.begin() + left, arr.begin() + mid + 1, scratch.begin());
+  auto out = arr.begin() + left;
+  auto i = scratch.begin();
+  auto j = arr.begin() + mid + 1;
+  auto end = arr.begin() + right + 1;
+  while (i != buffered && j != end) {
+    observer.onCompare();
+    if (*j < *i) {
+      *out++ = std::move(*j++);
+    } else {
+      *out++ = std::move(*i++);
+    }
+  }
+  std::move(i, buffered, out);
+}
+
+/**
+ * @brief One bottom-up pass: merges neighbouring runs of length width from src into dst
+ *
+ * Pairs that are already in order (last of the left run not greater than the
+ * first of the right run) are moved across without comparing the rest.
+ */
+template <std::random_access_iterator Src, std::random_access_iterator Dst, typename Compare,
+          SortObserver Observer = NullSortObserver>
+void mergePass(Src src, Dst dst, std::ptrdiff_t n, std::ptrdiff_t width, Compare comp,
+               Observer observer = {}) {
+  for (std::ptrdiff_t left = 0; left < n; left += 2 * width) {
+    std::ptrdiff_t mid = std::min(left + width, n);
+    std::ptrdiff_t right = std::min(left + 2 * width, n);
+    if (mid == right || !comp(src[mid], src[mid - 1])) {
+      observer.onMove(static_cast<std::size_t>(right - left));
+      std::move(src + left, src + right, dst + left);
+    } else {
+      mergeRuns(src + left, src + mid, src + mid, src + right, dst + left, comp, observer);
+    }
+  }
+}
+
+/**
+ * @brief Stable bottom-up merge sort of [first, last)
+ *
+ * Insertion sorts runs of kMergeSortRunLength (integer keys use sorting
+ * networks, whose reordering of equal keys is unobservable), then merges runs
+ * of doubling width, ping-ponging between the range and buffer so no pass
+ * allocates.
+ *
+ * @param buffer Start of a scratch range of at least last - first elements
+ * @param comp Ordering applied to the projected elements
+ * @param proj Projection applied to each element before comparing
+ * @param observer Sees every comparison and move; each merge pass is one level
+ */
+template <std::random_access_iterator It, std::random_access_iterator Buf,
+          typename Compare = std::ranges::less, typename Proj = std::identity,
+          SortObserver Observer = NullSortObserver>
+  requires SortableIterator<It, Compare, Proj> &&
+           std::indirectly_writable<Buf, std::iter_rvalue_reference_t<It>>
+void mergeSort(It first, It last, Buf buffer, Compare comp = {}, Proj proj = {},
+               Observer observer = {}) {
+  auto observed = observeComparisons(projectedComparator(comp, proj), observer);
+  auto n = last - first;
+  for (std::ptrdiff_t run = 0; run < n; run += kMergeSortRunLength) {
+    auto runEnd = first + std::min(run + kMergeSortRunLength, n);
+    if constexpr (std::integral<std::iter_value_t<It>>) {
+      smallSort(first + run, runEnd, observed, observer);
+    } else {
+      insertionSortImpl(first + run, runEnd, observed, observer);
+    }
+  }
+  bool inBuffer = false;
+  std::size_t pass = 0;
+  for (std::ptrdiff_t width = kMergeSortRunLength; width < n; width *= 2) {
+    observer.onRecurse(++pass);
+    if (inBuffer) {
+      mergePass(buffer, first, n, width, observed, observer);
+    } else {
+      mergePass(first, buffer, n, width, observed, observer);
+    }
+    inBuffer = !inBuffer;
+  }
+  if (inBuffer) {
+    observer.onMove(static_cast<std::size_t>(n));
+    std::move(buffer, buffer + n, first);
+  }
+}
+
+/**
+ * @brief Stable merge sort of [first, last) with scratch space allocated
+ *        from resource, skipped entirely for inputs of a single run
+ *
+ * @param resource Where the scratch comes from; nullptr picks the thread's
+ *        scratch arena for small inputs and the default resource otherwise
+ *        (see SortScratchLease)
+ */
+template <std::random_access_iterator It, typename Compare = std::ranges::less,
+          typename Proj = std::identity, SortObserver Observer = NullSortObserver>
+  requires SortableIterator<It, Compare, Proj> && std::copyable<std::iter_value_t<It>>
+void mergeSort(It first, It last, std::pmr::memory_resource* resource, Compare comp = {},
+               Proj proj = {}, Observer observer = {}) {
+  if (last - first <= kMergeSortRunLength) {
+    insertionSort(first, last, comp, proj, observer);
     return;
   }
-  std::cout << "MergeSort: left=" << left << " right=" << right << '\n';
-  size_t mid = left + (right - left) / 2;
-  mergeSortImpl(arr, left, mid);
-  mergeSortImpl(arr, mid + 1, right);
-  merge(arr, left, mid, right);
+  using T = std::iter_value_t<It>;
+  std::size_t bytes = static_cast<std::size_t>(last - first) * sizeof(T);
+  SortScratchLease lease(bytes, resource);
+  observer.onAllocate(bytes);
+  std::pmr::vector<T> scratch(first, last, lease.resource());
+  mergeSort(first, last, scratch.begin(), comp, proj, observer);
+}
+
+/**
+ * @brief Stable merge sort of [first, last) that allocates its own scratch
+ *        space, skipped entirely for inputs of a single run
+ */
+template <std::random_access_iterator It, typename Compare = std::ranges::less,
+          typename Proj = std::identity, SortObserver Observer = NullSortObserver>
+  requires SortableIterator<It, Compare, Proj> && std::copyable<std::iter_value_t<It>>
+void mergeSort(It first, It last, Compare comp = {}, Proj proj = {}, Observer observer = {}) {
+  mergeSort(first, last, static_cast<std::pmr::memory_resource*>(nullptr), comp, proj, observer);
+}
+
+template <std::ranges::random_access_range R, typename Compare = std::ranges::less,
+          typename Proj = std::identity, SortObserver Observer = NullSortObserver>
+  requires MergeableRange<R, Compare, Proj>
+void mergeSort(R&& range, Compare comp = {}, Proj proj = {}, Observer observer = {}) {
+  auto first = std::ranges::begin(range);
+  mergeSort(first, std::ranges::next(first, std::ranges::end(range)), comp, proj, observer);
+}
+
+/**
+ * @brief Stable merge sort using caller-provided scratch space
+ *
+ * @throws std::invalid_argument if scratch is smaller than arr
+ */
+template <Mergeable T, SortObserver Observer = NullSortObserver>
+void mergeSort(std::vector<T>& arr, std::span<T> scratch, Observer observer = {}) {
+  if (scratch.size() < arr.size()) {
+    throw std::invalid_argument("mergeSort scratch is smaller than the input");
+  }
+  mergeSort(arr.begin(), arr.end(), scratch.begin(), std::less<>{}, std::identity{}, observer);
+}
+
+template <Mergeable T, SortObserver Observer = NullSortObserver>
+void mergeSort(std::vector<T>& arr, std::pmr::memory_resource* resource, Observer observer = {}) {
+  mergeSort(arr.begin(), arr.end(), resource, std::less<>{}, std::identity{}, observer);
+}
+
+template <Mergeable T, SortObserver Observer = NullSortObserver>
+void mergeSort(std::vector<T>& arr, Observer observer = {}) {
+  mergeSort(arr.begin(), arr.end(), std::less<>{}, std::identity{}, observer);
+}
+
+/**
+ * @brief Merge-path (co-rank) search
+ *
+ * Finds how many elements of the sorted run a (length aLen) are among the
+ * first k outputs of a stable merge of a with the sorted run b (length bLen).
+ * The remaining k - i outputs come from b.
+ */
+template <std::random_access_iterator It, typename Compare>
+std::ptrdiff_t mergePathSplit(It a, std::ptrdiff_t aLen, It b, std::ptrdiff_t bLen,
+                              std::ptrdiff_t k, Compare comp) {
+  std::ptrdiff_t low = std::max<std::ptrdiff_t>(0, k - bLen);
+  std::ptrdiff_t high = std::min(k, aLen);
+  while (low < high) {
+    std::ptrdiff_t i = low + (high - low) / 2;
+    std::ptrdiff_t j = k - i;
+    // b[j - 1] precedes a[i] in the output, so no more of a is needed.
+    if (j == 0 || comp(b[j - 1], a[i])) {
+      high = i;
+    } else {
+      low = i + 1;
+    }
+  }
+  return low;
+}
+
+/**
+ * @brief Merges every pair of neighbouring runs described by bounds from src
+ *        into dst, with each thread producing an equal slice of the output
+ *
+ * A thread locates the start and end of its slice inside every merge it
+ * overlaps with mergePathSplit, so one large merge is shared by all threads.
+ * A trailing unpaired run is moved across unchanged.
+ */
+template <std::random_access_iterator Src, std::random_access_iterator Dst, typename Compare>
+void parallelMergeLevel(Src src, Dst dst, const std::vector<std::ptrdiff_t>& bounds,
+                        std::size_t threads, Compare comp) {
+  auto n = static_cast<std::size_t>(bounds.back());
+  parallelFor(threads, [&](std::size_t t) {
+    auto [sliceBegin, sliceEnd] = chunkBounds(n, threads, t);
+    for (std::size_t r = 0; r + 1 < bounds.size(); r += 2) {
+      std::ptrdiff_t left = bounds[r];
+      std::ptrdiff_t mid = bounds[r + 1];
+      std::ptrdiff_t right = r + 2 < bounds.size() ? bounds[r + 2] : mid;
+      std::ptrdiff_t begin = std::max(left, static_cast<std::ptrdiff_t>(sliceBegin));
+      std::ptrdiff_t end = std::min(right, static_cast<std::ptrdiff_t>(sliceEnd));
+      if (begin >= end) {
+        continue;
+      }
+      std::ptrdiff_t i0 = mergePathSplit(src + left, mid - left, src + mid, right - mid,
+                                         begin - left, comp);
+      std::ptrdiff_t i1 =
+          mergePathSplit(src + left, mid - left, src + mid, right - mid, end - left, comp);
+      std::ptrdiff_t j0 = begin - left - i0;
+      std::ptrdiff_t j1 = end - left - i1;
+      mergeRuns(src + left + i0, src + left + i1, src + mid + j0, src + mid + j1, dst + begin,
+                comp);
+    }
+  });
+}
+
+/**
+ * @brief Stable parallel merge sort of [first, last)
+ *
+ * Each thread sorts one contiguous leaf run with the bottom-up mergeSort.
+ * The runs are then merged pairwise level by level, ping-ponging between the
+ * range and buffer, and every level is split evenly across all threads with
+ * merge-path partitioning so the final merges are not serialized.
+ *
+ * @param buffer Start of a scratch range of at least last - first elements
+ * @param threads Number of worker threads; 0 uses the hardware concurrency
+ */
+template <std::random_access_iterator It, std::random_access_iterator Buf, typename Compare>
+void parallelMergeSort(It first, It last, Buf buffer, Compare comp, std::size_t threads = 0) {
+  threads = resolveThreadCount(threads);
+  auto n = last - first;
+  if (threads == 1 || n <= kParallelMergeSortThreshold) {
+    mergeSort(first, last, buffer, comp);
+    return;
+  }
+
+  std::vector<std::ptrdiff_t> bounds(threads + 1);
+  for (std::size_t t = 0; t <= threads; ++t) {
+    bounds[t] = static_cast<std::ptrdiff_t>(chunkBounds(n, threads, t).first);
+  }
+  bounds[threads] = n;
+  parallelFor(threads, [&](std::size_t t) {
+    mergeSort(first + bounds[t], first + bounds[t + 1], buffer + bounds[t], comp);
+  });
+
+  bool inBuffer = false;
+  while (bounds.size() > 2) {
+    if (inBuffer) {
+      parallelMergeLevel(buffer, first, bounds, threads, comp);
+    } else {
+      parallelMergeLevel(first, buffer, bounds, threads, comp);
+    }
+    inBuffer = !inBuffer;
+    std::vector<std::ptrdiff_t> merged;
+    for (std::size_t r = 0; r < bounds.size(); r += 2) {
+      merged.push_back(bounds[r]);
+    }
+    if (merged.back() != n) {
+      merged.push_back(n);
+    }
+    bounds = std::move(merged);
+  }
+  if (inBuffer) {
+    parallelFor(threads, [&](std::size_t t) {
+      auto [begin, end] = chunkBounds(n, threads, t);
+      std::move(buffer + begin, buffer + end, first + begin);
+    });
+  }
+}
+
+/**
+ * @brief Stable parallel merge sort using caller-provided scratch space
+ *
+ * @throws std::invalid_argument if scratch is smaller than arr
+ */
+template <Mergeable T>
+void parallelMergeSort(std::vector<T>& arr, std::span<T> scratch, std::size_t threads = 0) {
+  if (scratch.size() < arr.size()) {
+    throw std::invalid_argument("parallelMergeSort scratch is smaller than the input");
+  }
+  parallelMergeSort(arr.begin(), arr.end(), scratch.begin(), std::less<>{}, threads);
+}
+
+template <std::ranges::random_access_range R, typename Compare = std::ranges::less,
+          typename Proj = std::identity>
+  requires MergeableRange<R, Compare, Proj>
+void parallelMergeSort(R&& range, Compare comp = {}, Proj proj = {}, std::size_t threads = 0) {
+  auto first = std::ranges::begin(range);
+  auto last = std::ranges::next(first, std::ranges::end(range));
+  std::vector<std::ranges::range_value_t<R>> scratch(first, last);
+  parallelMergeSort(first, last, scratch.begin(), projectedComparator(comp, proj), threads);
 }
 
 template <Mergeable T>
-void mergeSort(std::vector<T>& arr) {
-  std::cout << "Starting mergeSort with array size: " << arr.size() << '\n';
-  std::span s{arr};
-  mergeSortImpl(s, 0, arr.size() - 1);
+void parallelMergeSort(std::vector<T>& arr, std::size_t threads = 0) {
+  std::vector<T> scratch(arr);
+  parallelMergeSort(arr, std::span<T>{scratch}, threads);
 }
 
-#endif  // MERGE_SORT_HPP
\ No newline at end of file
+#endif  // MERGE_SORT_HPP
@@ -0,0 +1,358 @@
+#ifndef MULTIWAY_MERGE_HPP
+#define MULTIWAY_MERGE_HPP
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "sorting_concepts.hpp"
+#include "sorting_network.hpp"
+#include "sorting_parallel.hpp"
+
+// Merges producing at most this many elements are not worth splitting across threads.
+inline constexpr std::size_t kParallelMultiwayMergeThreshold = std::size_t{1} << 16;
+
+// A range of sorted runs whose iterators stay valid while the runs are merged:
+// the runs are lvalues in the outer range or borrowed ranges such as spans.
+template <typename Runs>
+concept MergeableRuns =
+    std::ranges::input_range<Runs> &&
+    std::ranges::input_range<std::ranges::range_reference_t<Runs>> &&
+    (std::is_lvalue_reference_v<std::ranges::range_reference_t<Runs>> ||
+     std::ranges::borrowed_range<std::ranges::range_reference_t<Runs>>);
+
+/**
+ * @brief Tournament tree of losers over k sorted input runs
+ *
+ * Leaf i holds the head of run i, each internal node the run that lost the
+ * match played there, and the root's winner the run whose head comes next.
+ * Popping advances the winner and replays only the matches on its path to
+ * the root, one comparison per level, so each element costs ceil(log2 k)
+ * comparisons against the two of a binary heap's sift-down.
+ *
+ * Nodes live in one flat array and carry the head they stand for: a copy for
+ * small trivially copyable values or values the iterator yields by value,
+ * and a pointer into the run otherwise. A replay thus reads one node per
+ * level and never goes back to the iterators, and for arithmetic values
+ * under the natural order it runs without branches. Ties go to the run with the
+ * lower index, so a merge through the tree is stable with respect to run
+ * order. Exhausted runs lose every match.
+ */
+template <std::input_iterator It, std::sentinel_for<It> S, typename Compare>
+class LoserTree {
+  using Value = std::iter_value_t<It>;
+  static constexpr bool kCopiesHeads =
+      !std::is_lvalue_reference_v<std::iter_reference_t<It>> ||
+      (std::is_trivially_copyable_v<Value> && sizeof(Value) <= 16);
+  // Arithmetic heads under the natural order are compared on every node of
+  // the path, live or not, so a replay needs no branches. Other comparators
+  // may not accept the placeholder head of a padding leaf or empty run.
+  static constexpr bool kBranchless = std::is_arithmetic_v<Value> && NaturalOrder<Compare, Value>;
+  // Copied heads other than arithmetic ones sit in an optional, so Value
+  // need not be default constructible.
+  using Head =
+      std::conditional_t<kBranchless, Value,
+                         std::conditional_t<kCopiesHeads, std::optional<Value>, const Value*>>;
+
+  struct Node {
+    Head head{};
+    std::uint32_t run = 0;
+    bool live = false;
+  };
+
+ public:
+  LoserTree(std::vector<std::pair<It, S>> runs, Compare comp)
+      : runs_(std::move(runs)),
+        leaves_(std::bit_ceil(std::max<std::size_t>(runs_.size(), 1))),
+        losers_(leaves_),
+        comp_(std::move(comp)) {
+    std::vector<Node> winners(2 * leaves_);
+    for (std::size_t leaf = 0; leaf < leaves_; ++leaf) {
+      winners[leaves_ + leaf].run = static_cast<std::uint32_t>(leaf);
+      load(winners[leaves_ + leaf]);
+    }
+    for (std::size_t node = leaves_ - 1; node > 0; --node) {
+      Node& a = winners[2 * node];
+      Node& b = winners[2 * node + 1];
+      bool aWins = beats(a, b);
+      losers_[node] = std::move(aWins ? b : a);
+      winners[node] = std::move(aWins ? a : b);
+    }
+    winner_ = std::move(winners[1]);
+  }
+
+  bool empty() const { return !winner_.live; }
+
+  // Index of the run whose head comes next.
+  std::size_t winner() const { return winner_.run; }
+
+  const Value& top() const { return value(winner_); }
+
+  // Moves the winning run past its head and replays its path to the root.
+  void pop() {
+    ++runs_[winner_.run].first;
+    load(winner_);
+    if constexpr (kBranchless) {
+      // Both comparisons and every field are selected without branching, so
+      // the replay does not stall on the unpredictable outcome of a match.
+      Node current = winner_;
+      for (std::size_t node = (leaves_ + current.run) / 2; node > 0; node /= 2) {
+        Node& loser = losers_[node];
+        bool less = comp_(loser.head, current.head);
+        bool greater = comp_(current.head, loser.head);
+        bool swap = loser.live & (!current.live | less | (!greater & (loser.run < current.run)));
+        Node next{swap ? loser.head : current.head, swap ? loser.run : current.run,
+                  swap ? loser.live : current.live};
+        loser.head = swap ? current.head : loser.head;
+        loser.run = swap ? current.run : loser.run;
+        loser.live = swap ? current.live : loser.live;
+        current = next;
+      }
+      winner_ = current;
+    } else {
+      for (std::size_t node = (leaves_ + winner_.run) / 2; node > 0; node /= 2) {
+        if (beats(losers_[node], winner_)) {
+          std::swap(losers_[node], winner_);
+        }
+      }
+    }
+  }
+
+ private:
+  void load(Node& node) {
+    node.live = node.run < runs_.size() && runs_[node.run].first != runs_[node.run].second;
+    if (node.live) {
+      if constexpr (kCopiesHeads) {
+        node.head = *runs_[node.run].first;
+      } else {
+        node.head = std::addressof(*runs_[node.run].first);
+      }
+    }
+  }
+
+  static const Value& value(const Node& node) {
+    if constexpr (kBranchless) {
+      return node.head;
+    } else if constexpr (kCopiesHeads) {
+      return *node.head;
+    } else {
+      return *node.head;
+    }
+  }
+
+  bool beats(const Node& a, const Node& b) const {
+    if (a.live & b.live) {
+      return a.run < b.run ? !comp_(value(b), value(a)) : comp_(value(a), value(b));
+    }
+    return a.live;
+  }
+
+  std::vector<std::pair<It, S>> runs_;
+  std::size_t leaves_;
+  std::vector<Node> losers_;
+  Node winner_;
+  Compare comp_;
+};
+
+/**
+ * @brief Stable k-way merge of sorted runs into out with a loser tree
+ *
+ * Runs can be anything with input iterators: vectors, spans, lists or
+ * std::views::istream over a file of records, mixed only in that they share
+ * one iterator type. Equal elements keep the order of their runs, and within
+ * a run their order in it. Elements are copied into out.
+ *
+ * @return Iterator past the last element written
+ */
+template <MergeableRuns Runs, std::weakly_incrementable Out,
+          typename Compare = std::ranges::less, typename Proj = std::identity>
+  requires std::copyable<std::ranges::range_value_t<std::ranges::range_reference_t<Runs>>> &&
+           std::indirectly_copyable<std::ranges::iterator_t<std::ranges::range_reference_t<Runs>>,
+                                    Out> &&
+           std::indirect_strict_weak_order<
+               Compare,
+               std::projected<std::ranges::iterator_t<std::ranges::range_reference_t<Runs>>, Proj>>
+Out multiwayMerge(Runs&& runs, Out out, Compare comp = {}, Proj proj = {}) {
+  using Run = std::ranges::range_reference_t<Runs>;
+  using It = std::ranges::iterator_t<Run>;
+  using S = std::ranges::sentinel_t<Run>;
+  std::vector<std::pair<It, S>> cursors;
+  for (auto&& run : runs) {
+    cursors.emplace_back(std::ranges::begin(run), std::ranges::end(run));
+  }
+  if (cursors.size() == 1) {
+    return std::ranges::copy(std::move(cursors[0].first), cursors[0].second, std::move(out)).out;
+  }
+  LoserTree<It, S, decltype(projectedComparator(comp, proj))> tree(
+      std::move(cursors), projectedComparator(comp, proj));
+  while (!tree.empty()) {
+    *out = tree.top();
+    ++out;
+    tree.pop();
+  }
+  return out;
+}
+
+/**
+ * @brief Multiway co-rank: how many elements of each sorted run are among
+ *        the first rank outputs of a stable merge of all of them
+ *
+ * Keeps a window of possible counts per run. Each round takes the middle
+ * element of every open window, picks the median of those elements weighted
+ * by window size as the pivot, and ranks the pivot in every run by binary
+ * search. If fewer than rank elements precede it, the pivot and everything
+ * before it are taken, otherwise it and everything after it are not, which
+ * closes at least a quarter of the open positions per round. The cost is
+ * O(k log n) comparisons per round for O(log n) rounds.
+ *
+ * @param runs The sorted runs as (first, last) pairs
+ * @return counts with counts[i] elements taken from run i, summing to rank
+ */
+template <std::random_access_iterator It, typename Compare>
+std::vector<std::ptrdiff_t> multiwayMergeSplit(const std::vector<std::pair<It, It>>& runs,
+                                               std::ptrdiff_t rank, Compare comp) {
+  std::size_t k = runs.size();
+  std::vector<std::ptrdiff_t> low(k, 0);
+  std::vector<std::ptrdiff_t> high(k);
+  for (std::size_t i = 0; i < k; ++i) {
+    high[i] = runs[i].second - runs[i].first;
+  }
+  struct Candidate {
+    std::size_t run;
+    std::ptrdiff_t position;
+    std::ptrdiff_t weight;
+  };
+  // Stable merge order: by value, then run, then position within the run.
+  auto precedes = [&](const Candidate& a, const Candidate& b) {
+    const auto& x = runs[a.run].first[a.position];
+    const auto& y = runs[b.run].first[b.position];
+    if (comp(x, y)) {
+      return true;
+    }
+    if (comp(y, x)) {
+      return false;
+    }
+    return a.run < b.run || (a.run == b.run && a.position < b.position);
+  };
+  std::vector<Candidate> candidates;
+  for (;;) {
+    candidates.clear();
+    std::ptrdiff_t open = 0;
+    for (std::size_t i = 0; i < k; ++i) {
+      if (low[i] < high[i]) {
+        candidates.push_back({i, low[i] + (high[i] - low[i]) / 2, high[i] - low[i]});
+        open += high[i] - low[i];
+      }
+    }
+    if (candidates.empty()) {
+      return low;
+    }
+    std::ranges::sort(candidates, precedes);
+    std::ptrdiff_t seen = 0;
+    Candidate pivot = candidates.back();
+    for (const Candidate& candidate : candidates) {
+      seen += candidate.weight;
+      if (2 * seen >= open) {
+        pivot = candidate;
+        break;
+      }
+    }
+
+    const auto& value = runs[pivot.run].first[pivot.position];
+    std::vector<std::ptrdiff_t> before(k);
+    std::ptrdiff_t preceding = 0;
+    for (std::size_t i = 0; i < k; ++i) {
+      auto [first, last] = runs[i];
+      if (i < pivot.run) {
+        before[i] = std::upper_bound(first, last, value, comp) - first;
+      } else if (i > pivot.run) {
+        before[i] = std::lower_bound(first, last, value, comp) - first;
+      } else {
+        before[i] = pivot.position;
+      }
+      preceding += before[i];
+    }
+    if (preceding < rank) {
+      for (std::size_t i = 0; i < k; ++i) {
+        low[i] = std::max(low[i], before[i] + (i == pivot.run ? 1 : 0));
+      }
+    } else {
+      for (std::size_t i = 0; i < k; ++i) {
+        high[i] = std::min(high[i], before[i]);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Stable k-way merge of sorted random-access runs into out, with each
+ *        thread writing an equal slice of the output
+ *
+ * The boundaries between slices are found with multiwayMergeSplit, after
+ * which every thread merges its part of each run through its own loser tree
+ * with no further coordination. The output matches multiwayMerge.
+ *
+ * @param threads Number of worker threads; 0 uses the hardware concurrency
+ * @return Iterator past the last element written
+ */
+template <MergeableRuns Runs, std::random_access_iterator Out,
+          typename Compare = std::ranges::less, typename Proj = std::identity>
+  requires std::ranges::random_access_range<std::ranges::range_reference_t<Runs>> &&
+           std::indirectly_copyable<std::ranges::iterator_t<std::ranges::range_reference_t<Runs>>,
+                                    Out> &&
+           std::indirect_strict_weak_order<
+               Compare,
+               std::projected<std::ranges::iterator_t<std::ranges::range_reference_t<Runs>>, Proj>>
+Out parallelMultiwayMerge(Runs&& runs, Out out, Compare comp = {}, Proj proj = {},
+                          std::size_t threads = 0) {
+  using It = std::ranges::iterator_t<std::ranges::range_reference_t<Runs>>;
+  std::vector<std::pair<It, It>> bounds;
+  std::ptrdiff_t n = 0;
+  for (auto&& run : runs) {
+    auto first = std::ranges::begin(run);
+    auto last = std::ranges::next(first, std::ranges::end(run));
+    bounds.emplace_back(first, last);
+    n += last - first;
+  }
+  threads = resolveThreadCount(threads);
+  if (threads == 1 || static_cast<std::size_t>(n) <= kParallelMultiwayMergeThreshold) {
+    return multiwayMerge(runs, out, comp, proj);
+  }
+  auto less = projectedComparator(comp, proj);
+
+  std::vector<std::vector<std::ptrdiff_t>> splits(threads + 1);
+  splits[0].assign(bounds.size(), 0);
+  for (std::size_t i = 0; i < bounds.size(); ++i) {
+    splits[threads].push_back(bounds[i].second - bounds[i].first);
+  }
+  parallelFor(threads - 1, [&](std::size_t t) {
+    auto rank = static_cast<std::ptrdiff_t>(chunkBounds(static_cast<std::size_t>(n), threads,
+                                                        t + 1).first);
+    splits[t + 1] = multiwayMergeSplit(bounds, rank, less);
+  });
+  parallelFor(threads, [&](std::size_t t) {
+    std::vector<std::pair<It, It>> slice;
+    std::ptrdiff_t offset = 0;
+    for (std::size_t i = 0; i < bounds.size(); ++i) {
+      slice.emplace_back(bounds[i].first + splits[t][i], bounds[i].first + splits[t + 1][i]);
+      offset += splits[t][i];
+    }
+    multiwayMerge(slice | std::views::transform([](const std::pair<It, It>& part) {
+                    return std::ranges::subrange(part.first, part.second);
+                  }),
+                  out + offset, less);
+  });
+  return out + n;
+}
+
+#endif  // MULTIWAY_MERGE_HPP
@@ -0,0 +1,364 @@
+#ifndef PDQ_SORT_HPP
+#define PDQ_SORT_HPP
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "heap_sort.hpp"
+#include "insertion_sort.hpp"
+#include "quick_sort.hpp"
+#include "sort_observer.hpp"
+#include "sorting_concepts.hpp"
+#include "sorting_network.hpp"
+
+// Ranges below this size are finished with insertion sort, or with a sorting
+// network of up to kSortingNetworkMaxSize when the keys allow it.
+inline constexpr std::ptrdiff_t kPdqSortInsertionThreshold = 24;
+// Ranges above this size pick their pivot with Tukey's ninther.
+inline constexpr std::ptrdiff_t kPdqSortNintherThreshold = 128;
+// Element moves a partial insertion sort may spend before giving up.
+inline constexpr std::ptrdiff_t kPdqSortPartialInsertionLimit = 8;
+// Elements classified per block by the branchless partition; offsets fit a byte.
+inline constexpr std::ptrdiff_t kPdqSortBlockSize = 64;
+
+/**
+ * @brief Insertion sort that gives up after kPdqSortPartialInsertionLimit
+ *        element moves
+ *
+ * @return Whether [first, last) ended up sorted
+ */
+template <std::random_access_iterator It, typename Compare>
+bool partialInsertionSort(It first, It last, Compare comp) {
+  if (first == last) {
+    return true;
+  }
+  std::ptrdiff_t moves = 0;
+  for (It i = std::next(first); i != last; ++i) {
+    if (!comp(*i, *std::prev(i))) {
+      continue;
+    }
+    auto value = std::move(*i);
+    It hole = i;
+    do {
+      *hole = std::move(*std::prev(hole));
+      --hole;
+    } while (hole != first && comp(value, *std::prev(hole)));
+    *hole = std::move(value);
+    moves += i - hole;
+    if (moves > kPdqSortPartialInsertionLimit) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Partitions [first, last) around the pivot in *first, putting
+ *        elements equal to it on the left
+ *
+ * Used when the pivot equals the element just before the range, which means
+ * every element equal to it is already in its final place.
+ *
+ * @return Final position of the pivot
+ */
+template <std::random_access_iterator It, typename Compare>
+It pdqPartitionLeft(It first, It last, Compare comp) {
+  auto pivot = std::move(*first);
+  It i = first;
+  It j = last;
+  while (comp(pivot, *--j)) {
+  }
+  if (std::next(j) == last) {
+    while (i < j && !comp(pivot, *++i)) {
+    }
+  } else {
+    while (!comp(pivot, *++i)) {
+    }
+  }
+  while (i < j) {
+    std::iter_swap(i, j);
+    while (comp(pivot, *--j)) {
+    }
+    while (!comp(pivot, *++i)) {
+    }
+  }
+  *first = std::move(*j);
+  *j = std::move(pivot);
+  return j;
+}
+
+/**
+ * @brief Swaps the elements at the recorded offsets of two blocks
+ *
+ * When the counts differ the swaps are chained through a single temporary
+ * into a cyclic rotation, which halves the moves.
+ */
+template <std::random_access_iterator It>
+void pdqSwapOffsets(It leftBase, It rightBase, const unsigned char* leftOffsets,
+                    const unsigned char* rightOffsets, std::ptrdiff_t count, bool useSwaps) {
+  if (useSwaps) {
+    // Needed for descending inputs, where a rotation would break the O(n)
+    // pattern detection.
+    for (std::ptrdiff_t i = 0; i < count; ++i) {
+      std::iter_swap(leftBase + leftOffsets[i], rightBase - rightOffsets[i]);
+    }
+  } else if (count > 0) {
+    It l = leftBase + leftOffsets[0];
+    It r = rightBase - rightOffsets[0];
+    auto value = std::move(*l);
+    *l = std::move(*r);
+    for (std::ptrdiff_t i = 1; i < count; ++i) {
+      l = leftBase + leftOffsets[i];
+      *r = std::move(*l);
+      r = rightBase - rightOffsets[i];
+      *l = std::move(*r);
+    }
+    *r = std::move(value);
+  }
+}
+
+/**
+ * @brief Partitions [first, last) around the pivot in *first, putting
+ *        elements equal to it on the right
+ *
+ * With Branchless set, the main loop is BlockQuicksort's: blocks of
+ * kPdqSortBlockSize elements from each end are classified against the pivot
+ * into offset buffers without a data-dependent branch, then the misplaced
+ * elements are swapped pairwise, so random keys cost no branch mispredictions.
+ *
+ * @return Final position of the pivot, and whether no element had to move
+ */
+template <bool Branchless, std::random_access_iterator It, typename Compare>
+std::pair<It, bool> pdqPartitionRight(It first, It last, Compare comp) {
+  auto pivot = std::move(*first);
+  It i = first;
+  It j = last;
+  // The median-of-three guarantees an element not less than the pivot at the end.
+  while (comp(*++i, pivot)) {
+  }
+  if (std::prev(i) == first) {
+    while (i < j && !comp(*--j, pivot)) {
+    }
+  } else {
+    while (!comp(*--j, pivot)) {
+    }
+  }
+  bool alreadyPartitioned = i >= j;
+
+  if constexpr (Branchless) {
+    if (!alreadyPartitioned) {
+      std::iter_swap(i, j);
+      ++i;
+      alignas(64) unsigned char leftOffsets[kPdqSortBlockSize];
+      alignas(64) unsigned char rightOffsets[kPdqSortBlockSize];
+      It leftBase = i;
+      It rightBase = j;
+      std::ptrdiff_t leftCount = 0;
+      std::ptrdiff_t rightCount = 0;
+      std::ptrdiff_t leftStart = 0;
+      std::ptrdiff_t rightStart = 0;
+      while (i < j) {
+        // Only refill the blocks that are empty; split the unknown elements
+        // between them when both are.
+        std::ptrdiff_t unknown = j - i;
+        std::ptrdiff_t leftSplit = leftCount == 0 ? (rightCount == 0 ? unknown / 2 : unknown) : 0;
+        std::ptrdiff_t rightSplit = rightCount == 0 ? unknown - leftSplit : 0;
+
+        std::ptrdiff_t leftScan = std::min(leftSplit, kPdqSortBlockSize);
+        for (std::ptrdiff_t k = 0; k < leftScan; ++k) {
+          leftOffsets[leftCount] = static_cast<unsigned char>(k);
+          leftCount += !comp(*i, pivot);
+          ++i;
+        }
+        std::ptrdiff_t rightScan = std::min(rightSplit, kPdqSortBlockSize);
+        for (std::ptrdiff_t k = 0; k < rightScan;) {
+          rightOffsets[rightCount] = static_cast<unsigned char>(++k);
+          rightCount += comp(*--j, pivot);
+        }
+
+        std::ptrdiff_t count = std::min(leftCount, rightCount);
+        pdqSwapOffsets(leftBase, rightBase, leftOffsets + leftStart, rightOffsets + rightStart,
+                       count, leftCount == rightCount);
+        leftCount -= count;
+        rightCount -= count;
+        leftStart += count;
+        rightStart += count;
+        if (leftCount == 0) {
+          leftStart = 0;
+          leftBase = i;
+        }
+        if (rightCount == 0) {
+          rightStart = 0;
+          rightBase = j;
+        }
+      }
+      // One block may still hold misplaced elements; move them to the boundary.
+      if (leftCount > 0) {
+        while (leftCount-- > 0) {
+          std::iter_swap(leftBase + leftOffsets[leftStart + leftCount], --j);
+        }
+        i = j;
+      }
+      if (rightCount > 0) {
+        while (rightCount-- > 0) {
+          std::iter_swap(rightBase - rightOffsets[rightStart + rightCount], i);
+          ++i;
+        }
+        j = i;
+      }
+    }
+  } else {
+    while (i < j) {
+      std::iter_swap(i, j);
+      while (comp(*++i, pivot)) {
+      }
+      while (!comp(*--j, pivot)) {
+      }
+    }
+  }
+
+  It pivotPosition = std::prev(i);
+  *first = std::move(*pivotPosition);
+  *pivotPosition = std::move(pivot);
+  return {pivotPosition, alreadyPartitioned};
+}
+
+/**
+ * @brief pdqsort driver
+ *
+ * Quicksort with three pattern defenses on top of introsort:
+ * - a pivot equal to the element before the range means the range holds many
+ *   equal keys, which are swept left in one pass and never touched again;
+ * - a partition that moved nothing is followed by a bounded insertion sort
+ *   of both sides, so sorted and nearly sorted ranges finish in linear time;
+ * - a partition leaving less than 1/8 on one side swaps a few elements to
+ *   break up the pattern, and after badAllowed of those the range is heap
+ *   sorted.
+ */
+template <bool Branchless, std::random_access_iterator It, typename Compare,
+          SortObserver Observer = NullSortObserver>
+void pdqSortLoop(It first, It last, Compare comp, int badAllowed, bool leftmost,
+                 Observer observer = {}, std::size_t depth = 0) {
+  const std::ptrdiff_t smallSize = sortingNetworkApplies<It, Compare>()
+                                       ? kSortingNetworkMaxSize
+                                       : kPdqSortInsertionThreshold;
+  observer.onRecurse(depth);
+  for (;;) {
+    auto size = last - first;
+    if (size < smallSize) {
+      smallSort(first, last, comp, observer);
+      return;
+    }
+
+    auto half = size / 2;
+    if (size > kPdqSortNintherThreshold) {
+      sortThree(first, first + half, last - 1, comp, observer);
+      sortThree(first + 1, first + (half - 1), last - 2, comp, observer);
+      sortThree(first + 2, first + (half + 1), last - 3, comp, observer);
+      sortThree(first + (half - 1), first + half, first + (half + 1), comp, observer);
+      std::iter_swap(first, first + half);
+    } else {
+      sortThree(first + half, first, last - 1, comp, observer);
+    }
+
+    if (!leftmost && !comp(*std::prev(first), *first)) {
+      first = std::next(pdqPartitionLeft(first, last, comp));
+      continue;
+    }
+
+    auto [pivot, alreadyPartitioned] = pdqPartitionRight<Branchless>(first, last, comp);
+    auto leftSize = pivot - first;
+    auto rightSize = last - std::next(pivot);
+    if (leftSize < size / 8 || rightSize < size / 8) {
+      if (--badAllowed == 0) {
+        heapSortImpl(first, last, comp, observer);
+        return;
+      }
+      observer.onSwap();
+      if (leftSize >= kPdqSortInsertionThreshold) {
+        std::iter_swap(first, first + leftSize / 4);
+        std::iter_swap(pivot - 1, pivot - leftSize / 4);
+        if (leftSize > kPdqSortNintherThreshold) {
+          std::iter_swap(first + 1, first + (leftSize / 4 + 1));
+          std::iter_swap(first + 2, first + (leftSize / 4 + 2));
+          std::iter_swap(pivot - 2, pivot - (leftSize / 4 + 1));
+          std::iter_swap(pivot - 3, pivot - (leftSize / 4 + 2));
+        }
+      }
+      if (rightSize >= kPdqSortInsertionThreshold) {
+        std::iter_swap(pivot + 1, pivot + (1 + rightSize / 4));
+        std::iter_swap(last - 1, last - rightSize / 4);
+        if (rightSize > kPdqSortNintherThreshold) {
+          std::iter_swap(pivot + 2, pivot + (2 + rightSize / 4));
+          std::iter_swap(pivot + 3, pivot + (3 + rightSize / 4));
+          std::iter_swap(last - 2, last - (1 + rightSize / 4));
+          std::iter_swap(last - 3, last - (2 + rightSize / 4));
+        }
+      }
+    } else if (alreadyPartitioned && partialInsertionSort(first, pivot, comp) &&
+               partialInsertionSort(std::next(pivot), last, comp)) {
+      return;
+    }
+
+    pdqSortLoop<Branchless>(first, pivot, comp, badAllowed, leftmost, observer, depth + 1);
+    first = std::next(pivot);
+    leftmost = false;
+  }
+}
+
+/**
+ * @brief pdqSort engine over an already observed comparator, for sorts that
+ *        hand their base cases to it
+ */
+template <std::random_access_iterator It, typename Compare,
+          SortObserver Observer = NullSortObserver>
+void pdqSortImpl(It first, It last, Compare comp, Observer observer = {},
+                 std::size_t depth = 0) {
+  if (last - first < 2) {
+    return;
+  }
+  using T = std::iter_value_t<It>;
+  constexpr bool branchless = std::is_arithmetic_v<T> || std::is_pointer_v<T>;
+  auto badAllowed = static_cast<int>(std::bit_width(static_cast<std::size_t>(last - first)));
+  pdqSortLoop<branchless>(first, last, comp, badAllowed, true, observer, depth);
+}
+
+/**
+ * @brief Pattern-defeating quicksort of [first, last), a drop-in alternative
+ *        to quickSort
+ *
+ * Arithmetic and pointer keys use the branchless block partition; other keys,
+ * whose moves are expensive, use the plain Hoare-style partition. Sorted,
+ * reverse-sorted and equal-heavy inputs finish in linear time, and the worst
+ * case is O(n log n).
+ */
+template <std::random_access_iterator It, typename Compare = std::ranges::less,
+          typename Proj = std::identity, SortObserver Observer = NullSortObserver>
+  requires SortableIterator<It, Compare, Proj>
+void pdqSort(It first, It last, Compare comp = {}, Proj proj = {}, Observer observer = {}) {
+  pdqSortImpl(first, last, observeComparisons(projectedComparator(comp, proj), observer),
+              observer);
+}
+
+template <std::ranges::random_access_range R, typename Compare = std::ranges::less,
+          typename Proj = std::identity, SortObserver Observer = NullSortObserver>
+  requires SortableRange<R, Compare, Proj>
+void pdqSort(R&& range, Compare comp = {}, Proj proj = {}, Observer observer = {}) {
+  auto first = std::ranges::begin(range);
+  pdqSort(first, std::ranges::next(first, std::ranges::end(range)), comp, proj, observer);
+}
+
+template <Pivotable T, SortObserver Observer = NullSortObserver>
+void pdqSort(std::vector<T>& arr, Observer observer = {}) {
+  pdqSort(arr.begin(), arr.end(), std::less<>{}, std::identity{}, observer);
+}
+
+#endif  // PDQ_SORT_HPP
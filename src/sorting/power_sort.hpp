@@ -0,0 +1,323 @@
+#ifndef POWER_SORT_HPP
+#define POWER_SORT_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+#include "insertion_sort.hpp"
+#include "sort_observer.hpp"
+#include "sorting_concepts.hpp"
+#include "sorting_network.hpp"
+
+// Natural runs shorter than this are extended with insertion sort.
+inline constexpr std::ptrdiff_t kPowerSortMinRun = 32;
+// Consecutive wins by one side of a merge before it switches to galloping.
+inline constexpr std::ptrdiff_t kPowerSortMinGallop = 7;
+
+/**
+ * @brief Upper bound of value in the sorted range [first, last), found by
+ *        probing offsets 0, 2, 6, 14, ... from first before binary searching
+ *
+ * Costs O(log k) comparisons when the answer is k elements from first.
+ */
+template <std::random_access_iterator It, typename T, typename Compare>
+It gallopUpperBound(It first, It last, const T& value, Compare comp) {
+  auto n = last - first;
+  decltype(n) low = 0;
+  decltype(n) step = 1;
+  while (step <= n && !comp(value, first[step - 1])) {
+    low = step;
+    step = 2 * step + 1;
+  }
+  return std::upper_bound(first + low, first + std::min(step, n), value, comp);
+}
+
+/**
+ * @brief Lower bound of value in [first, last), galloping from first
+ */
+template <std::random_access_iterator It, typename T, typename Compare>
+It gallopLowerBound(It first, It last, const T& value, Compare comp) {
+  auto n = last - first;
+  decltype(n) low = 0;
+  decltype(n) step = 1;
+  while (step <= n && comp(first[step - 1], value)) {
+    low = step;
+    step = 2 * step + 1;
+  }
+  return std::lower_bound(first + low, first + std::min(step, n), value, comp);
+}
+
+/**
+ * @brief Upper bound of value in [first, last), galloping back from last
+ */
+template <std::random_access_iterator It, typename T, typename Compare>
+It gallopUpperBoundFromBack(It first, It last, const T& value, Compare comp) {
+  auto n = last - first;
+  auto high = n;
+  decltype(n) step = 1;
+  while (step <= n && comp(value, first[n - step])) {
+    high = n - step;
+    step = 2 * step + 1;
+  }
+  return std::upper_bound(first + std::max<decltype(n)>(n - step, 0), first + high, value, comp);
+}
+
+/**
+ * @brief Lower bound of value in [first, last), galloping back from last
+ */
+template <std::random_access_iterator It, typename T, typename Compare>
+It gallopLowerBoundFromBack(It first, It last, const T& value, Compare comp) {
+  auto n = last - first;
+  auto high = n;
+  decltype(n) step = 1;
+  while (step <= n && !comp(first[n - step], value)) {
+    high = n - step;
+    step = 2 * step + 1;
+  }
+  return std::lower_bound(first + std::max<decltype(n)>(n - step, 0), first + high, value, comp);
+}
+
+/**
+ * @brief Stable merge of the adjacent sorted runs [first, mid) and [mid, last)
+ *
+ * Elements of the left run that are already in place and elements of the
+ * right run that are already in place are found by galloping and never moved,
+ * so merging a short run into a long one costs O(short * log long). Only the
+ * shorter of the remaining runs is moved into buffer. During the merge, once
+ * one side wins kPowerSortMinGallop times in a row, whole blocks of it are
+ * located by galloping and moved at once.
+ */
+template <std::random_access_iterator It, typename T, typename Compare,
+          SortObserver Observer = NullSortObserver>
+void gallopingMerge(It first, It mid, It last, std::vector<T>& buffer, Compare comp,
+                    Observer observer = {}) {
+  first = gallopUpperBound(first, mid, *mid, comp);
+  if (first == mid) {
+    return;
+  }
+  last = gallopLowerBoundFromBack(mid, last, *std::prev(mid), comp);
+  auto leftSize = mid - first;
+  auto rightSize = last - mid;
+  auto reserve = [&](auto size) {
+    if (buffer.capacity() < static_cast<std::size_t>(size)) {
+      observer.onAllocate((static_cast<std::size_t>(size) - buffer.capacity()) * sizeof(T));
+    }
+  };
+  observer.onMove(2 * static_cast<std::size_t>(std::min(leftSize, rightSize)) +
+                  static_cast<std::size_t>(std::max(leftSize, rightSize)));
+
+  if (leftSize <= rightSize) {
+    // Merge forward with the left run in buffer; ties go to the left run.
+    reserve(leftSize);
+    buffer.assign(std::make_move_iterator(first), std::make_move_iterator(mid));
+    auto a = buffer.begin();
+    auto aEnd = buffer.end();
+    It b = mid;
+    It out = first;
+    while (a != aEnd && b != last) {
+      std::ptrdiff_t aWins = 0;
+      std::ptrdiff_t bWins = 0;
+      while (a != aEnd && b != last && aWins < kPowerSortMinGallop && bWins < kPowerSortMinGallop) {
+        if (comp(*b, *a)) {
+          *out++ = std::move(*b++);
+          ++bWins;
+          aWins = 0;
+        } else {
+          *out++ = std::move(*a++);
+          ++aWins;
+          bWins = 0;
+        }
+      }
+      while (a != aEnd && b != last) {
+        auto aRun = gallopUpperBound(a, aEnd, *b, comp);
+        out = std::move(a, aRun, out);
+        auto aTaken = aRun - a;
+        a = aRun;
+        if (a == aEnd) break;
+        It bRun = gallopLowerBound(b, last, *a, comp);
+        out = std::move(b, bRun, out);
+        auto bTaken = bRun - b;
+        b = bRun;
+        if (aTaken < kPowerSortMinGallop && bTaken < kPowerSortMinGallop) break;
+      }
+    }
+    std::move(a, aEnd, out);
+  } else {
+    // Merge backward with the right run in buffer; ties go to the right run.
+    reserve(rightSize);
+    buffer.assign(std::make_move_iterator(mid), std::make_move_iterator(last));
+    It aBegin = first;
+    It a = mid;
+    auto bBegin = buffer.begin();
+    auto b = buffer.end();
+    It out = last;
+    while (a != aBegin && b != bBegin) {
+      std::ptrdiff_t aWins = 0;
+      std::ptrdiff_t bWins = 0;
+      while (a != aBegin && b != bBegin && aWins < kPowerSortMinGallop &&
+             bWins < kPowerSortMinGallop) {
+        if (comp(*std::prev(b), *std::prev(a))) {
+          *--out = std::move(*--a);
+          ++aWins;
+          bWins = 0;
+        } else {
+          *--out = std::move(*--b);
+          ++bWins;
+          aWins = 0;
+        }
+      }
+      while (a != aBegin && b != bBegin) {
+        It aRun = gallopUpperBoundFromBack(aBegin, a, *std::prev(b), comp);
+        out = std::move_backward(aRun, a, out);
+        auto aTaken = a - aRun;
+        a = aRun;
+        if (a == aBegin) break;
+        auto bRun = gallopLowerBoundFromBack(bBegin, b, *std::prev(a), comp);
+        out = std::move_backward(bRun, b, out);
+        auto bTaken = b - bRun;
+        b = bRun;
+        if (aTaken < kPowerSortMinGallop && bTaken < kPowerSortMinGallop) break;
+      }
+    }
+    std::move_backward(bBegin, b, out);
+  }
+}
+
+/**
+ * @brief Powersort node power of the boundary between the adjacent runs
+ *        [begin, begin + leftSize) and [begin + leftSize, begin + leftSize + rightSize)
+ *        of an n-element input
+ *
+ * The power is the depth at which the boundary would sit in a perfectly
+ * balanced merge tree over [0, n); merging the stack while its top power
+ * exceeds the new one yields merge costs within O(n) of optimal.
+ */
+inline int powerSortNodePower(std::ptrdiff_t begin, std::ptrdiff_t leftSize,
+                              std::ptrdiff_t rightSize, std::ptrdiff_t n) {
+  int power = 0;
+  std::ptrdiff_t a = 2 * begin + leftSize;
+  std::ptrdiff_t b = a + leftSize + rightSize;
+  for (;;) {
+    ++power;
+    if (a >= n) {
+      a -= n;
+      b -= n;
+    } else if (b >= n) {
+      break;
+    }
+    a <<= 1;
+    b <<= 1;
+  }
+  return power;
+}
+
+/**
+ * @brief Finds the natural run starting at first and returns its end
+ *
+ * Strictly descending runs are reversed in place; requiring strictness keeps
+ * equal elements in their original order. Runs shorter than minRun are
+ * extended with insertion sort, or a sorting network for integer keys whose
+ * equal elements are indistinguishable.
+ */
+template <std::random_access_iterator It, typename Compare,
+          SortObserver Observer = NullSortObserver>
+It powerSortRun(It first, It last, std::ptrdiff_t minRun, Compare comp, Observer observer = {}) {
+  It end = std::next(first);
+  if (end == last) {
+    return end;
+  }
+  if (comp(*end, *first)) {
+    while (++end != last && comp(*end, *std::prev(end))) {
+    }
+    observer.onMove(static_cast<std::size_t>(end - first));
+    std::reverse(first, end);
+  } else {
+    while (++end != last && !comp(*end, *std::prev(end))) {
+    }
+  }
+  if (end - first < minRun && end != last) {
+    end = first + std::min(minRun, last - first);
+    if constexpr (std::integral<std::iter_value_t<It>>) {
+      smallSort(first, end, comp, observer);
+    } else {
+      insertionSortImpl(first, end, comp, observer);
+    }
+  }
+  return end;
+}
+
+/**
+ * @brief Stable run-adaptive merge sort of [first, last) (powersort)
+ *
+ * Scans the input once for natural ascending and strictly descending runs,
+ * then merges neighbouring runs as the powersort policy dictates using
+ * galloping merges. Already sorted and reverse-sorted inputs take n - 1
+ * comparisons, and input that is sorted except for a few out-of-place
+ * elements costs close to O(n). Scratch space grows to at most half the
+ * input, and only when a merge needs it.
+ */
+template <std::random_access_iterator It, typename Compare = std::ranges::less,
+          typename Proj = std::identity, SortObserver Observer = NullSortObserver>
+  requires SortableIterator<It, Compare, Proj> && std::movable<std::iter_value_t<It>>
+void powerSort(It first, It last, Compare comp = {}, Proj proj = {}, Observer observer = {}) {
+  auto n = last - first;
+  if (n < 2) {
+    return;
+  }
+  auto less = observeComparisons(projectedComparator(comp, proj), observer);
+
+  struct Run {
+    It begin;
+    It end;
+    int power;
+  };
+  std::vector<Run> runs;
+  std::vector<std::iter_value_t<It>> buffer;
+  auto mergeTop = [&] {
+    Run right = runs.back();
+    runs.pop_back();
+    gallopingMerge(runs.back().begin, right.begin, right.end, buffer, less, observer);
+    runs.back().end = right.end;
+  };
+
+  It runBegin = first;
+  while (runBegin != last) {
+    It runEnd = powerSortRun(runBegin, last, kPowerSortMinRun, less, observer);
+    if (!runs.empty()) {
+      const Run& previous = runs.back();
+      int power = powerSortNodePower(previous.begin - first, previous.end - previous.begin,
+                                     runEnd - runBegin, n);
+      while (runs.size() > 1 && runs[runs.size() - 2].power > power) {
+        mergeTop();
+      }
+      runs.back().power = power;
+    }
+    runs.push_back({runBegin, runEnd, 0});
+    observer.onRecurse(runs.size());
+    runBegin = runEnd;
+  }
+  while (runs.size() > 1) {
+    mergeTop();
+  }
+}
+
+template <std::ranges::random_access_range R, typename Compare = std::ranges::less,
+          typename Proj = std::identity, SortObserver Observer = NullSortObserver>
+  requires SortableRange<R, Compare, Proj> && std::movable<std::ranges::range_value_t<R>>
+void powerSort(R&& range, Compare comp = {}, Proj proj = {}, Observer observer = {}) {
+  auto first = std::ranges::begin(range);
+  powerSort(first, std::ranges::next(first, std::ranges::end(range)), comp, proj, observer);
+}
+
+template <Pivotable T, SortObserver Observer = NullSortObserver>
+void powerSort(std::vector<T>& arr, Observer observer = {}) {
+  powerSort(arr.begin(), arr.end(), std::less<>{}, std::identity{}, observer);
+}
+
+#endif  // POWER_SORT_HPP
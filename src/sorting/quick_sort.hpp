@@ -1,44 +1,322 @@
 #ifndef QUICK_SORT_HPP
 #define QUICK_SORT_HPP
 
+#include <algorithm>
+#include <bit>
 #include <concepts>
-#include <iostream>
+#include <cstddef>
+#include <functional>
+#include <iterator>
 #include <ranges>
+#include <utility>
 #include <vector>
 
+#include "heap_sort.hpp"
+#include "insertion_sort.hpp"
+#include "sort_observer.hpp"
 #include "sorting_concepts.hpp"
+#include "sorting_network.hpp"
+#include "sorting_parallel.hpp"
+
+// Ranges at or below this size are finished with insertion sort, or with a
+// sorting network of up to kSortingNetworkMaxSize when the keys allow it.
+inline constexpr std::ptrdiff_t kQuickSortInsertionThreshold = 24;
+// Ranges above this size pick their pivot with Tukey's ninther.
+inline constexpr std::ptrdiff_t kQuickSortNintherThreshold = 128;
+// Smallest range a parallel worker forks instead of sorting sequentially.
+inline constexpr std::ptrdiff_t kParallelQuickSortGrain = std::ptrdiff_t{1} << 14;
+// Smallest range partitioned cooperatively by all workers.
+inline constexpr std::ptrdiff_t kParallelPartitionThreshold = std::ptrdiff_t{1} << 16;
+
+/**
+ * @brief Sorts the three referenced elements in place
+ */
+template <std::random_access_iterator It, typename Compare,
+          SortObserver Observer = NullSortObserver>
+void sortThree(It a, It b, It c, Compare comp, Observer observer = {}) {
+  auto exchange = [&](It x, It y) {
+    observer.onSwap();
+    std::iter_swap(x, y);
+  };
+  if (comp(*b, *a)) exchange(a, b);
+  if (comp(*c, *b)) exchange(b, c);
+  if (comp(*b, *a)) exchange(a, b);
+}
+
+/**
+ * @brief Moves a pivot estimate into *first
+ *
+ * Uses median-of-three for medium ranges and Tukey's ninther (median of three
+ * medians of three) for large ones, which keeps sorted, reverse-sorted and
+ * organ-pipe inputs well balanced.
+ */
+template <std::random_access_iterator It, typename Compare,
+          SortObserver Observer = NullSortObserver>
+void choosePivot(It first, It last, Compare comp, Observer observer = {}) {
+  auto n = last - first;
+  auto half = n / 2;
+  if (n > kQuickSortNintherThreshold) {
+    sortThree(first, first + half, last - 1, comp, observer);
+    sortThree(first + 1, first + (half - 1), last - 2, comp, observer);
+    sortThree(first + 2, first + (half + 1), last - 3, comp, observer);
+    sortThree(first + (half - 1), first + half, first + (half + 1), comp, observer);
+  } else {
+    sortThree(first, first + half, last - 1, comp, observer);
+  }
+  observer.onSwap();
+  std::iter_swap(first, first + half);
+}
+
+/**
+ * @brief Hoare partition of [first, last) around the pivot stored in *first
+ *
+ * Both scans stop on keys equal to the pivot, so ranges with many duplicates
+ * still split evenly.
+ *
+ * @return Final position of the pivot; elements before it are not greater and
+ *         elements after it are not less than the pivot
+ */
+template <std::random_access_iterator It, typename Compare,
+          SortObserver Observer = NullSortObserver>
+It partitionRange(It first, It last, Compare comp, Observer observer = {}) {
+  if (last - first < 2) {
+    return first;
+  }
+  It i = first;
+  It j = last;
+  for (;;) {
+    while (comp(*++i, *first)) {
+      if (i == last - 1) break;
+    }
+    while (comp(*first, *--j)) {
+    }
+    if (i >= j) break;
+    observer.onSwap();
+    std::iter_swap(i, j);
+  }
+  observer.onSwap();
+  std::iter_swap(first, j);
+  return j;
+}
 
 template <Pivotable T>
 size_t partition(std::vector<T>& arr, size_t low, size_t high) {
-  T pivot = std::move(arr[high]);
-  size_t i = low;
+  std::swap(arr[low], arr[high]);
+  auto first = arr.begin() + low;
+  return low + (partitionRange(first, arr.begin() + high + 1, std::less<>{}) - first);
+}
 
-  for (size_t j = low; j < high; ++j) {
-    if (arr[j] <= pivot) {
-      std::swap(arr[i++], arr[j]);
+/**
+ * @brief Introsort driver: quicksort that recurses into the smaller side,
+ *        switches to heap sort once depthLimit is exhausted and leaves small
+ *        ranges to smallSort
+ */
+template <std::random_access_iterator It, typename Compare,
+          SortObserver Observer = NullSortObserver>
+void introSortLoop(It first, It last, Compare comp, int depthLimit, Observer observer = {},
+                   std::size_t depth = 0) {
+  const std::ptrdiff_t smallSize = sortingNetworkApplies<It, Compare>()
+                                       ? kSortingNetworkMaxSize
+                                       : kQuickSortInsertionThreshold;
+  observer.onRecurse(depth);
+  while (last - first > smallSize) {
+    if (depthLimit == 0) {
+      heapSortImpl(first, last, comp, observer);
+      return;
+    }
+    --depthLimit;
+    choosePivot(first, last, comp, observer);
+    It pivot = partitionRange(first, last, comp, observer);
+    if (pivot - first < last - pivot) {
+      introSortLoop(first, pivot, comp, depthLimit, observer, depth + 1);
+      first = pivot + 1;
+    } else {
+      introSortLoop(pivot + 1, last, comp, depthLimit, observer, depth + 1);
+      last = pivot;
     }
   }
-  arr[high] = std::move(arr[i]);
-  arr[i] = std::move(pivot);
-  return i;
+  smallSort(first, last, comp, observer);
 }
 
-template <Pivotable T>
-void quickSortImpl(std::vector<T>& arr, size_t low, size_t high) {
-  std::cout << "QuickSort: low=" << low << " high=" << high << '\n';
-  if (low < high) {
-    size_t pi = partition(arr, low, high);
-    if (pi > 0) quickSortImpl(arr, low, pi - 1);
-    quickSortImpl(arr, pi + 1, high);
+template <std::random_access_iterator It>
+int introSortDepthLimit(It first, It last) {
+  return 2 * static_cast<int>(std::bit_width(static_cast<std::size_t>(last - first)));
+}
+
+/**
+ * @brief Introsort of [first, last) by comp applied to proj of each element,
+ *        like std::ranges::sort
+ */
+template <std::random_access_iterator It, typename Compare = std::ranges::less,
+          typename Proj = std::identity, SortObserver Observer = NullSortObserver>
+  requires SortableIterator<It, Compare, Proj>
+void quickSort(It first, It last, Compare comp = {}, Proj proj = {}, Observer observer = {}) {
+  introSortLoop(first, last, observeComparisons(projectedComparator(comp, proj), observer),
+                introSortDepthLimit(first, last), observer);
+}
+
+template <std::ranges::random_access_range R, typename Compare = std::ranges::less,
+          typename Proj = std::identity, SortObserver Observer = NullSortObserver>
+  requires SortableRange<R, Compare, Proj>
+void quickSort(R&& range, Compare comp = {}, Proj proj = {}, Observer observer = {}) {
+  auto first = std::ranges::begin(range);
+  quickSort(first, std::ranges::next(first, std::ranges::end(range)), comp, proj, observer);
+}
+
+template <Pivotable T, SortObserver Observer = NullSortObserver>
+void quickSort(std::vector<T>& arr, Observer observer = {}) {
+  quickSort(arr.begin(), arr.end(), std::less<>{}, std::identity{}, observer);
+}
+
+/**
+ * @brief Partitions [first, last) by a unary predicate using several threads
+ *
+ * Every thread partitions its own chunk, then the elements left on the wrong
+ * side of the global split point are exchanged pairwise, again in parallel.
+ * The partition is not stable.
+ *
+ * @return Iterator to the first element that does not satisfy pred
+ */
+template <std::random_access_iterator It, typename Predicate>
+It parallelPartition(It first, It last, Predicate pred, std::size_t threads) {
+  auto n = static_cast<std::size_t>(last - first);
+  std::vector<std::size_t> leftCount(threads);
+  parallelFor(threads, [&](std::size_t t) {
+    auto [begin, end] = chunkBounds(n, threads, t);
+    leftCount[t] = std::partition(first + begin, first + end, pred) - (first + begin);
+  });
+
+  std::size_t split = 0;
+  for (std::size_t count : leftCount) {
+    split += count;
+  }
+  // Collect [begin, end) runs of elements that sit on the wrong side of split.
+  std::vector<std::pair<std::size_t, std::size_t>> wrongLeft;
+  std::vector<std::pair<std::size_t, std::size_t>> wrongRight;
+  std::size_t misplaced = 0;
+  for (std::size_t t = 0; t < threads; ++t) {
+    auto [begin, end] = chunkBounds(n, threads, t);
+    std::size_t mid = begin + leftCount[t];
+    if (mid < split && mid < end) {
+      wrongLeft.emplace_back(mid, std::min(end, split));
+      misplaced += wrongLeft.back().second - wrongLeft.back().first;
+    }
+    if (mid > split && begin < mid) {
+      wrongRight.emplace_back(std::max(begin, split), mid);
+    }
   }
+
+  auto locate = [](const auto& runs, std::size_t k) {
+    std::size_t run = 0;
+    while (k >= runs[run].second - runs[run].first) {
+      k -= runs[run].second - runs[run].first;
+      ++run;
+    }
+    return std::pair{run, runs[run].first + k};
+  };
+  parallelFor(threads, [&](std::size_t t) {
+    auto [begin, end] = chunkBounds(misplaced, threads, t);
+    if (begin == end) return;
+    auto [leftRun, leftPos] = locate(wrongLeft, begin);
+    auto [rightRun, rightPos] = locate(wrongRight, begin);
+    for (std::size_t k = begin; k < end; ++k) {
+      if (leftPos == wrongLeft[leftRun].second) leftPos = wrongLeft[++leftRun].first;
+      if (rightPos == wrongRight[rightRun].second) rightPos = wrongRight[++rightRun].first;
+      std::iter_swap(first + leftPos++, first + rightPos++);
+    }
+  });
+  return first + split;
 }
 
-template <Pivotable T>
-void quickSort(std::vector<T>& arr) {
-  std::cout << "Starting quickSort with array size: " << arr.size() << '\n';
-  if (arr.size() > 1) {
-    quickSortImpl(arr, 0, arr.size() - 1);
+/**
+ * @brief Parallel introsort over [first, last)
+ *
+ * Ranges larger than one worker's share are partitioned cooperatively by all
+ * threads; the resulting subranges are then sorted fork-join style on a
+ * work-stealing scheduler, each task forking its smaller side and continuing
+ * with the larger one.
+ *
+ * @param threads Number of worker threads; 0 uses the hardware concurrency
+ */
+template <std::random_access_iterator It, typename Compare>
+void parallelQuickSort(It first, It last, Compare comp, std::size_t threads = 0) {
+  threads = resolveThreadCount(threads);
+  auto n = last - first;
+  if (threads == 1 || n <= kParallelQuickSortGrain) {
+    quickSort(first, last, comp);
+    return;
   }
+
+  struct Range {
+    It first;
+    It last;
+    int depthLimit;
+  };
+  auto splitThreshold =
+      std::max(n / static_cast<std::ptrdiff_t>(threads), kParallelPartitionThreshold);
+  std::vector<Range> stack{{first, last, introSortDepthLimit(first, last)}};
+  std::vector<Range> tasks;
+  while (!stack.empty()) {
+    Range range = stack.back();
+    stack.pop_back();
+    auto size = range.last - range.first;
+    if (size <= splitThreshold || range.depthLimit == 0) {
+      tasks.push_back(range);
+      continue;
+    }
+    choosePivot(range.first, range.last, comp);
+    const auto& pivotValue = *range.first;
+    It mid = parallelPartition(
+        range.first + 1, range.last, [&](const auto& x) { return comp(x, pivotValue); },
+        threads);
+    It pivot = mid - 1;
+    std::iter_swap(range.first, pivot);
+    It rightBegin = mid;
+    // A lopsided split means the pivot is heavily duplicated; peel off its
+    // equal keys so they are never touched again.
+    if (range.last - mid > size / 8 * 7) {
+      rightBegin = parallelPartition(
+          mid, range.last, [&](const auto& x) { return !comp(*pivot, x); }, threads);
+    }
+    stack.push_back({range.first, pivot, range.depthLimit - 1});
+    stack.push_back({rightBegin, range.last, range.depthLimit - 1});
+  }
+  std::ranges::sort(tasks, std::greater<>{}, [](const Range& r) { return r.last - r.first; });
+
+  runWorkStealing(threads, std::move(tasks), [&](Range range, auto& spawn) {
+    while (range.last - range.first > kParallelQuickSortGrain) {
+      if (range.depthLimit == 0) {
+        heapSortImpl(range.first, range.last, comp);
+        return;
+      }
+      choosePivot(range.first, range.last, comp);
+      It pivot = partitionRange(range.first, range.last, comp);
+      Range left{range.first, pivot, range.depthLimit - 1};
+      Range right{pivot + 1, range.last, range.depthLimit - 1};
+      if (left.last - left.first < right.last - right.first) {
+        spawn(left);
+        range = right;
+      } else {
+        spawn(right);
+        range = left;
+      }
+    }
+    introSortLoop(range.first, range.last, comp, range.depthLimit);
+  });
+}
+
+template <std::ranges::random_access_range R, typename Compare = std::ranges::less,
+          typename Proj = std::identity>
+  requires SortableRange<R, Compare, Proj>
+void parallelQuickSort(R&& range, Compare comp = {}, Proj proj = {}, std::size_t threads = 0) {
+  auto first = std::ranges::begin(range);
+  parallelQuickSort(first, std::ranges::next(first, std::ranges::end(range)),
+                    projectedComparator(comp, proj), threads);
+}
+
+template <Pivotable T>
+void parallelQuickSort(std::vector<T>& arr, std::size_t threads = 0) {
+  parallelQuickSort(arr.begin(), arr.end(), std::less<>{}, threads);
 }
 
-#endif  // QUICK_SORT_HPP
\ No newline at end of file
+#endif  // QUICK_SORT_HPP
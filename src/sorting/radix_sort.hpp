@@ -2,47 +2,620 @@
 #define RADIX_SORT_HPP
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <concepts>
-#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory_resource>
+#include <ranges>
 #include <span>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
 
-template <std::integral T>
-void radixSort(std::vector<T>& arr) {
-  std::cout << "Starting radixSort with array size: " << arr.size() << '\n';
-  if (arr.empty()) {
+#include "insertion_sort.hpp"
+#include "sample_sort.hpp"
+#include "sort_observer.hpp"
+#include "sort_scratch.hpp"
+#include "sorting_concepts.hpp"
+#include "sorting_parallel.hpp"
+
+// Digit width of the LSD passes: one byte per pass.
+inline constexpr unsigned kRadixBits = 8;
+inline constexpr std::size_t kRadixBuckets = std::size_t{1} << kRadixBits;
+// Inputs at or below this size are insertion sorted on their radix keys.
+inline constexpr std::size_t kRadixSortInsertionThreshold = 64;
+// radixSortBy scatters records up to this size directly instead of sorting
+// (key, index) pairs and gathering the records afterwards.
+inline constexpr std::size_t kRadixSortByDirectBytes = 16;
+// Inputs at or below this size are not worth splitting across threads.
+inline constexpr std::size_t kParallelRadixSortThreshold = std::size_t{1} << 16;
+// Size of each per-bucket write-combining buffer used by the parallel scatter.
+inline constexpr std::size_t kRadixWriteCombineBytes = 64;
+// American flag sort hands buckets at or below this size to pdqSort, which
+// insertion sorts the smallest; a 256-way pass costs more than it saves there.
+inline constexpr std::size_t kAmericanFlagSortComparisonThreshold = 1024;
+
+/**
+ * @brief Maps a value to an unsigned key of the same width whose unsigned
+ *        order matches the value order
+ *
+ * Signed integers get their sign bit flipped. Floating-point values flip the
+ * sign bit when positive and every bit when negative, which orders
+ * -inf < negatives < -0.0 < +0.0 < positives < +inf; NaNs go to the ends
+ * according to their sign bit.
+ */
+template <RadixSortable T>
+constexpr auto radixKey(T value) {
+  if constexpr (std::floating_point<T>) {
+    using Key = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+    constexpr Key signBit = Key{1} << (std::numeric_limits<Key>::digits - 1);
+    auto bits = std::bit_cast<Key>(value);
+    return static_cast<Key>(bits ^ ((bits & signBit) != 0 ? ~Key{0} : signBit));
+  } else {
+    using Key = std::make_unsigned_t<T>;
+    constexpr Key signBit = std::signed_integral<T>
+                                ? static_cast<Key>(Key{1} << (std::numeric_limits<Key>::digits - 1))
+                                : Key{0};
+    return static_cast<Key>(static_cast<Key>(value) ^ signBit);
+  }
+}
+
+template <RadixSortable T>
+constexpr std::size_t radixDigit(T value, unsigned pass) {
+  return static_cast<std::size_t>((radixKey(value) >> (pass * kRadixBits)) & (kRadixBuckets - 1));
+}
+
+template <RadixSortable T>
+inline constexpr unsigned kRadixPasses = sizeof(T) * 8 / kRadixBits;
+
+// Key type radixSortBy extracts from an R with KeyFn.
+template <typename R, typename KeyFn>
+using RadixKeyOf = std::remove_cvref_t<std::invoke_result_t<KeyFn&, const R&>>;
+
+/**
+ * @brief Stable LSD radix sort of records by the key that key extracts from
+ *        each of them, using buffer as the ping-pong target
+ *
+ * A single read pass builds the histograms of every digit. Passes in which all
+ * keys share the same digit are skipped, and the result is moved back into
+ * data only when an odd number of passes ran.
+ *
+ * @param data Records to sort
+ * @param buffer Scratch space of at least data.size() records
+ * @param key Maps a record to a RadixSortable key
+ * @param observer Sees every scatter pass as one level and its moves
+ * @throws std::invalid_argument if buffer is too small
+ */
+template <std::movable R, typename KeyFn, SortObserver Observer = NullSortObserver>
+  requires RadixSortable<RadixKeyOf<R, KeyFn>>
+void radixSortBy(std::span<R> data, std::span<R> buffer, KeyFn key, Observer observer = {}) {
+  using K = RadixKeyOf<R, KeyFn>;
+  std::size_t n = data.size();
+  auto digit = [&key](const R& record, unsigned pass) {
+    return radixDigit(static_cast<K>(std::invoke(key, record)), pass);
+  };
+  if (n <= kRadixSortInsertionThreshold) {
+    auto byKey = [&key](const R& a, const R& b) {
+      return radixKey(static_cast<K>(std::invoke(key, a))) <
+             radixKey(static_cast<K>(std::invoke(key, b)));
+    };
+    insertionSortImpl(data.begin(), data.end(), observeComparisons(byKey, observer), observer);
+    return;
+  }
+  if (buffer.size() < n) {
+    throw std::invalid_argument("radixSort buffer is smaller than the input");
+  }
+
+  std::array<std::array<std::size_t, kRadixBuckets>, kRadixPasses<K>> counts{};
+  for (const R& record : data) {
+    for (unsigned pass = 0; pass < kRadixPasses<K>; ++pass) {
+      ++counts[pass][digit(record, pass)];
+    }
+  }
+
+  std::span<R> src = data;
+  std::span<R> dst = buffer.first(n);
+  std::size_t scatters = 0;
+  for (unsigned pass = 0; pass < kRadixPasses<K>; ++pass) {
+    auto& offsets = counts[pass];
+    if (offsets[digit(src[0], pass)] == n) {
+      continue;
+    }
+    observer.onRecurse(++scatters);
+    observer.onMove(n);
+    std::size_t sum = 0;
+    for (auto& offset : offsets) {
+      std::size_t count = offset;
+      offset = sum;
+      sum += count;
+    }
+    for (R& record : src) {
+      dst[offsets[digit(record, pass)]++] = std::move(record);
+    }
+    std::swap(src, dst);
+  }
+  if (src.data() != data.data()) {
+    observer.onMove(n);
+    std::move(src.begin(), src.end(), data.begin());
+  }
+}
+
+/**
+ * @brief Stable LSD radix sort of records by the key that key extracts from
+ *        each of them, with scratch space allocated from resource
+ *
+ * Records of up to kRadixSortByDirectBytes are scattered directly. Larger
+ * records would be moved once per pass, so their keys are extracted once into
+ * (key, index) pairs, the pairs are radix sorted, and the records are then
+ * gathered into place with a single move each way. Records that are not
+ * default constructible always take the indirect route, since the direct one
+ * needs a buffer of them.
+ *
+ * @param resource Where the scratch comes from; nullptr picks the thread's
+ *        scratch arena for small inputs and the default resource otherwise
+ *        (see SortScratchLease)
+ */
+template <std::movable R, typename KeyFn, SortObserver Observer = NullSortObserver>
+  requires RadixSortable<RadixKeyOf<R, KeyFn>>
+void radixSortBy(std::span<R> data, std::pmr::memory_resource* resource, KeyFn key,
+                 Observer observer = {}) {
+  using K = RadixKeyOf<R, KeyFn>;
+  std::size_t n = data.size();
+  if (n <= kRadixSortInsertionThreshold) {
+    radixSortBy(data, std::span<R>{}, key, observer);
+    return;
+  }
+  if constexpr (sizeof(R) <= kRadixSortByDirectBytes && std::default_initializable<R>) {
+    SortScratchLease lease(n * sizeof(R), resource);
+    observer.onAllocate(n * sizeof(R));
+    std::pmr::vector<R> buffer(n, lease.resource());
+    radixSortBy(data, std::span<R>{buffer}, key, observer);
+  } else {
+    auto sortIndirect = [&]<typename Index>() {
+      struct KeyIndex {
+        K key;
+        Index index;
+      };
+      std::size_t bytes = 2 * n * sizeof(KeyIndex) + n * sizeof(R);
+      SortScratchLease lease(bytes, resource);
+      observer.onAllocate(bytes);
+      std::pmr::vector<KeyIndex> pairs(n, lease.resource());
+      for (std::size_t i = 0; i < n; ++i) {
+        pairs[i] = {static_cast<K>(std::invoke(key, data[i])), static_cast<Index>(i)};
+      }
+      std::pmr::vector<KeyIndex> buffer(n, lease.resource());
+      radixSortBy(std::span<KeyIndex>{pairs}, std::span<KeyIndex>{buffer}, &KeyIndex::key,
+                  observer);
+      observer.onMove(2 * n);
+      std::pmr::vector<R> gathered(lease.resource());
+      gathered.reserve(n);
+      for (const KeyIndex& pair : pairs) {
+        gathered.push_back(std::move(data[pair.index]));
+      }
+      std::ranges::move(gathered, data.begin());
+    };
+    if (n - 1 <= std::numeric_limits<std::uint32_t>::max()) {
+      sortIndirect.template operator()<std::uint32_t>();
+    } else {
+      sortIndirect.template operator()<std::uint64_t>();
+    }
+  }
+}
+
+/**
+ * @brief Stable LSD radix sort of records by the key that key extracts from
+ *        each of them, allocating its own scratch space
+ */
+template <std::movable R, typename KeyFn, SortObserver Observer = NullSortObserver>
+  requires RadixSortable<RadixKeyOf<R, KeyFn>>
+void radixSortBy(std::span<R> data, KeyFn key, Observer observer = {}) {
+  radixSortBy(data, static_cast<std::pmr::memory_resource*>(nullptr), key, observer);
+}
+
+template <std::movable R, typename KeyFn, SortObserver Observer = NullSortObserver>
+  requires RadixSortable<RadixKeyOf<R, KeyFn>>
+void radixSortBy(std::vector<R>& arr, KeyFn key, Observer observer = {}) {
+  radixSortBy(std::span<R>{arr}, key, observer);
+}
+
+/**
+ * @brief LSD radix sort of data using buffer as the ping-pong target
+ *
+ * @param data Values to sort
+ * @param buffer Scratch space of at least data.size() elements
+ * @param observer Sees every scatter pass as one level and its moves
+ * @throws std::invalid_argument if buffer is too small
+ */
+template <RadixSortable T, SortObserver Observer = NullSortObserver>
+void radixSort(std::span<T> data, std::span<T> buffer, Observer observer = {}) {
+  radixSortBy(data, buffer, std::identity{}, observer);
+}
+
+/**
+ * @brief LSD radix sort of data with its scratch buffer allocated from
+ *        resource
+ *
+ * @param resource Where the buffer comes from; nullptr picks the thread's
+ *        scratch arena for small inputs and the default resource otherwise
+ *        (see SortScratchLease)
+ */
+template <RadixSortable T, SortObserver Observer = NullSortObserver>
+void radixSort(std::span<T> data, std::pmr::memory_resource* resource, Observer observer = {}) {
+  if (data.size() <= kRadixSortInsertionThreshold) {
+    radixSort(data, std::span<T>{}, observer);
     return;
+  }
+  SortScratchLease lease(data.size() * sizeof(T), resource);
+  observer.onAllocate(data.size() * sizeof(T));
+  std::pmr::vector<T> buffer(data.size(), lease.resource());
+  radixSort(data, std::span<T>{buffer}, observer);
+}
+
+/**
+ * @brief LSD radix sort of data that allocates its own scratch buffer
+ *
+ * Sorts any contiguous slice in place, such as part of a mapped file or a
+ * column of a larger array.
+ */
+template <RadixSortable T, SortObserver Observer = NullSortObserver>
+void radixSort(std::span<T> data, Observer observer = {}) {
+  radixSort(data, static_cast<std::pmr::memory_resource*>(nullptr), observer);
+}
+
+template <RadixSortable T, SortObserver Observer = NullSortObserver>
+void radixSort(std::vector<T>& arr, std::pmr::memory_resource* resource, Observer observer = {}) {
+  radixSort(std::span<T>{arr}, resource, observer);
+}
+
+template <RadixSortable T, SortObserver Observer = NullSortObserver>
+void radixSort(std::vector<T>& arr, Observer observer = {}) {
+  radixSort(std::span<T>{arr}, observer);
+}
+
+/**
+ * @brief Classifies records by one radix digit of their key, so the block
+ *        permutation of sampleSortPartition can distribute them
+ */
+template <typename R, typename KeyFn>
+class RadixDigitClassifier {
+ public:
+  RadixDigitClassifier(KeyFn key, unsigned pass) : key_(key), pass_(pass) {}
+
+  std::size_t buckets() const { return kRadixBuckets; }
+
+  std::size_t operator()(const R& record) const {
+    return radixDigit(static_cast<RadixKeyOf<R, KeyFn>>(std::invoke(key_, record)), pass_);
+  }
+
+  template <std::random_access_iterator It, typename Yield>
+  void classify(It first, It last, Yield&& yield) const {
+    for (; first != last; ++first) {
+      yield((*this)(*first), first);
+    }
+  }
+
+ private:
+  KeyFn key_;
+  unsigned pass_;
+};
+
+/**
+ * @brief American flag sort of data by the digits of key at pass and below
+ *
+ * Counts the digits of the range, then swaps every record of a bucket's
+ * unplaced tail into the next free slot of the bucket it belongs to. Each
+ * swap leaves one record in its final slot. The records swapped back in are
+ * handled in the next round, instead of following each cycle to its end, so
+ * consecutive swaps are independent and their cache misses overlap.
+ * Buckets are then sorted by the next digit down. Digits that every record
+ * of a range shares cost one counting pass and no moves.
+ */
+template <std::movable R, typename KeyFn, SortObserver Observer = NullSortObserver>
+  requires RadixSortable<RadixKeyOf<R, KeyFn>>
+void americanFlagSortPass(std::span<R> data, const KeyFn& key, unsigned pass,
+                          Observer observer = {}, std::size_t depth = 0) {
+  using K = RadixKeyOf<R, KeyFn>;
+  auto keyOf = [&key](const R& record) {
+    return radixKey(static_cast<K>(std::invoke(key, record)));
   };
-  /*
-   * Commented out because it causes errors in the CI environment.
-   ** auto max = std::ranges::max(arr);
-   */
-  auto max = *std::max_element(arr.begin(), arr.end());
-  std::span s{arr};
+  for (;;) {
+    if (data.size() <= kAmericanFlagSortComparisonThreshold) {
+      auto byKey = [&keyOf](const R& a, const R& b) { return keyOf(a) < keyOf(b); };
+      pdqSortImpl(data.begin(), data.end(), observeComparisons(byKey, observer), observer, depth);
+      return;
+    }
+    auto digit = [&keyOf, pass](const R& record) {
+      return static_cast<std::size_t>((keyOf(record) >> (pass * kRadixBits)) &
+                                      (kRadixBuckets - 1));
+    };
+    std::array<std::size_t, kRadixBuckets> heads{};
+    for (const R& record : data) {
+      ++heads[digit(record)];
+    }
+    if (heads[digit(data[0])] == data.size()) {
+      if (pass == 0) {
+        return;
+      }
+      --pass;
+      continue;
+    }
+
+    observer.onRecurse(depth);
+    std::array<std::size_t, kRadixBuckets + 1> bounds{};
+    for (std::size_t b = 0; b < kRadixBuckets; ++b) {
+      bounds[b + 1] = bounds[b] + heads[b];
+      heads[b] = bounds[b];
+    }
+    std::array<std::size_t, kRadixBuckets> unfinished;
+    std::size_t unfinishedCount = 0;
+    for (std::size_t b = 0; b < kRadixBuckets; ++b) {
+      if (heads[b] < bounds[b + 1]) {
+        unfinished[unfinishedCount++] = b;
+      }
+    }
+    std::size_t swaps = 0;
+    while (unfinishedCount > 0) {
+      std::size_t kept = 0;
+      for (std::size_t i = 0; i < unfinishedCount; ++i) {
+        std::size_t b = unfinished[i];
+        std::size_t end = bounds[b + 1];
+        swaps += end - heads[b];
+        for (std::size_t slot = heads[b]; slot < end; ++slot) {
+          std::swap(data[slot], data[heads[digit(data[slot])]++]);
+        }
+        if (heads[b] < end) {
+          unfinished[kept++] = b;
+        }
+      }
+      unfinishedCount = kept;
+    }
+    observer.onMove(3 * swaps);
+
+    if (pass == 0) {
+      return;
+    }
+    for (std::size_t b = 0; b < kRadixBuckets; ++b) {
+      if (bounds[b + 1] - bounds[b] > 1) {
+        americanFlagSortPass(data.subspan(bounds[b], bounds[b + 1] - bounds[b]), key, pass - 1,
+                             observer, depth + 1);
+      }
+    }
+    return;
+  }
+}
+
+/**
+ * @brief In-place MSD radix sort (American flag sort) of records by the key
+ *        that key extracts from each of them
+ *
+ * Needs no buffer at all: memory stays at a few histograms however large the
+ * input, where radixSortBy needs a second copy of it. Buckets of up to
+ * kAmericanFlagSortComparisonThreshold records are comparison sorted. Not
+ * stable.
+ */
+template <std::movable R, typename KeyFn, SortObserver Observer = NullSortObserver>
+  requires RadixSortable<RadixKeyOf<R, KeyFn>>
+void americanFlagSortBy(std::span<R> data, KeyFn key, Observer observer = {}) {
+  if (data.size() > 1) {
+    americanFlagSortPass(data, key, kRadixPasses<RadixKeyOf<R, KeyFn>> - 1, observer);
+  }
+}
+
+template <RadixSortable T, SortObserver Observer = NullSortObserver>
+void americanFlagSort(std::span<T> data, Observer observer = {}) {
+  americanFlagSortBy(data, std::identity{}, observer);
+}
+
+template <RadixSortable T, SortObserver Observer = NullSortObserver>
+void americanFlagSort(std::vector<T>& arr, Observer observer = {}) {
+  americanFlagSort(std::span<T>{arr}, observer);
+}
+
+/**
+ * @brief Multithreaded LSD radix sort of data using buffer as the ping-pong target
+ *
+ * Each pass splits the source into one contiguous chunk per thread. Every
+ * thread histograms its chunk, a prefix sum over (digit, thread) hands each
+ * thread disjoint output offsets per digit, and the threads scatter in
+ * parallel. Each thread stages its writes in cache-line sized per-digit
+ * buffers so the scattered stores leave as whole lines. Ordering across
+ * chunks follows thread order, so each pass stays stable.
+ *
+ * @param data Values to sort
+ * @param buffer Scratch space of at least data.size() elements
+ * @param threads Number of worker threads; 0 uses the hardware concurrency
+ * @throws std::invalid_argument if buffer is too small
+ */
+template <RadixSortable T>
+void parallelRadixSort(std::span<T> data, std::span<T> buffer, std::size_t threads = 0) {
+  threads = resolveThreadCount(threads);
+  std::size_t n = data.size();
+  if (threads == 1 || n <= kParallelRadixSortThreshold) {
+    radixSort(data, buffer);
+    return;
+  }
+  if (buffer.size() < n) {
+    throw std::invalid_argument("parallelRadixSort buffer is smaller than the input");
+  }
+
+  using Histogram = std::array<std::size_t, kRadixBuckets>;
+  std::vector<std::array<Histogram, kRadixPasses<T>>> local(threads);
+  parallelFor(threads, [&](std::size_t t) {
+    auto [begin, end] = chunkBounds(n, threads, t);
+    for (T value : data.subspan(begin, end - begin)) {
+      for (unsigned pass = 0; pass < kRadixPasses<T>; ++pass) {
+        ++local[t][pass][radixDigit(value, pass)];
+      }
+    }
+  });
+  std::array<Histogram, kRadixPasses<T>> totals{};
+  for (const auto& histograms : local) {
+    for (unsigned pass = 0; pass < kRadixPasses<T>; ++pass) {
+      for (std::size_t digit = 0; digit < kRadixBuckets; ++digit) {
+        totals[pass][digit] += histograms[pass][digit];
+      }
+    }
+  }
+
+  constexpr std::size_t lineSize = std::max<std::size_t>(kRadixWriteCombineBytes / sizeof(T), 1);
+  std::vector<std::vector<T>> staging(threads, std::vector<T>(kRadixBuckets * lineSize));
+  std::vector<Histogram> offsets(threads);
+  std::span<T> src = data;
+  std::span<T> dst = buffer.first(n);
+  bool permuted = false;
+  for (unsigned pass = 0; pass < kRadixPasses<T>; ++pass) {
+    if (totals[pass][radixDigit(src[0], pass)] == n) {
+      continue;
+    }
+    // The up-front histograms describe the chunks only until the first scatter.
+    if (permuted) {
+      parallelFor(threads, [&](std::size_t t) {
+        auto [begin, end] = chunkBounds(n, threads, t);
+        offsets[t].fill(0);
+        for (T value : src.subspan(begin, end - begin)) {
+          ++offsets[t][radixDigit(value, pass)];
+        }
+      });
+    } else {
+      for (std::size_t t = 0; t < threads; ++t) {
+        offsets[t] = local[t][pass];
+      }
+    }
+    std::size_t sum = 0;
+    for (std::size_t digit = 0; digit < kRadixBuckets; ++digit) {
+      for (std::size_t t = 0; t < threads; ++t) {
+        std::size_t count = offsets[t][digit];
+        offsets[t][digit] = sum;
+        sum += count;
+      }
+    }
+
+    parallelFor(threads, [&](std::size_t t) {
+      auto [begin, end] = chunkBounds(n, threads, t);
+      auto& next = offsets[t];
+      auto lines = staging[t].begin();
+      std::array<std::size_t, kRadixBuckets> fill{};
+      for (T value : src.subspan(begin, end - begin)) {
+        std::size_t digit = radixDigit(value, pass);
+        lines[digit * lineSize + fill[digit]] = value;
+        if (++fill[digit] == lineSize) {
+          std::copy_n(lines + digit * lineSize, lineSize, dst.begin() + next[digit]);
+          next[digit] += lineSize;
+          fill[digit] = 0;
+        }
+      }
+      for (std::size_t digit = 0; digit < kRadixBuckets; ++digit) {
+        std::copy_n(lines + digit * lineSize, fill[digit], dst.begin() + next[digit]);
+      }
+    });
+    std::swap(src, dst);
+    permuted = true;
+  }
+  if (src.data() != data.data()) {
+    parallelFor(threads, [&](std::size_t t) {
+      auto [begin, end] = chunkBounds(n, threads, t);
+      std::copy(src.begin() + begin, src.begin() + end, data.begin() + begin);
+    });
+  }
+}
+
+template <RadixSortable T>
+void parallelRadixSort(std::span<T> data, std::size_t threads = 0) {
+  std::vector<T> buffer(data.size());
+  parallelRadixSort(data, std::span<T>{buffer}, threads);
+}
 
-  for (T exp = 1; max / exp > 0; exp *= 10) {
-    std::cout << "Processing digit position: " << exp << '\n';
-    std::vector<T> output(s.size());
-    std::array<size_t, 10> count{};
+template <RadixSortable T>
+void parallelRadixSort(std::vector<T>& arr, std::size_t threads = 0) {
+  parallelRadixSort(std::span<T>{arr}, threads);
+}
+
+/**
+ * @brief Multithreaded in-place MSD radix sort of data
+ *
+ * Leading bits shared by every key are found with one parallel scan and
+ * skipped. Ranges larger than one worker's share are then distributed by
+ * their next digit with the block permutation of sampleSortPartition, which
+ * all threads run together in O(threads) blocks of extra memory; the
+ * remaining buckets are finished by americanFlagSort on a work-stealing
+ * scheduler, largest first. Sorting 200 GB of keys therefore needs only a
+ * few megabytes on top of the keys themselves.
+ *
+ * @param threads Number of worker threads; 0 uses the hardware concurrency
+ */
+template <RadixSortable T>
+void parallelAmericanFlagSort(std::span<T> data, std::size_t threads = 0) {
+  threads = resolveThreadCount(threads);
+  std::size_t n = data.size();
+  if (threads == 1 || n <= kParallelRadixSortThreshold) {
+    americanFlagSort(data);
+    return;
+  }
 
-    for (const auto& val : s) {
-      count[(val / exp) % 10]++;
+  using K = decltype(radixKey(T{}));
+  std::vector<K> differing(threads);
+  parallelFor(threads, [&](std::size_t t) {
+    auto [begin, end] = chunkBounds(n, threads, t);
+    K bits = 0;
+    for (T value : data.subspan(begin, end - begin)) {
+      bits |= radixKey(value) ^ radixKey(data[0]);
     }
-    for (size_t i = 1; i < 10; i++) {
-      count[i] += count[i - 1];
+    differing[t] = bits;
+  });
+  K bits = 0;
+  for (K chunk : differing) {
+    bits |= chunk;
+  }
+  if (bits == 0) {
+    return;
+  }
+
+  struct Range {
+    std::span<T> data;
+    unsigned pass;
+  };
+  auto splitThreshold = std::max(n / threads, kParallelRadixSortThreshold);
+  auto topPass = static_cast<unsigned>((std::bit_width(bits) - 1) / kRadixBits);
+  SampleSortScratch<T> scratch(threads);
+  std::vector<T> noSplitters;
+  std::vector<Range> stack{{data, topPass}};
+  std::vector<Range> tasks;
+  while (!stack.empty()) {
+    Range range = stack.back();
+    stack.pop_back();
+    if (range.data.size() <= splitThreshold) {
+      if (range.data.size() > 1) {
+        tasks.push_back(range);
+      }
+      continue;
+    }
+    RadixDigitClassifier<T, std::identity> classifier({}, range.pass);
+    auto bounds = sampleSortPartition(range.data.begin(), range.data.end(),
+                                      static_cast<std::ptrdiff_t>(range.data.size()), classifier,
+                                      noSplitters, scratch, NullSortObserver{});
+    if (range.pass == 0) {
+      continue;
     }
-    for (auto it = s.rbegin(); it != s.rend(); ++it) {
-      size_t idx = (*it / exp) % 10;
-      output[count[idx] - 1] = *it;
-      count[idx]--;
+    for (std::size_t b = 0; b < kRadixBuckets; ++b) {
+      auto size = static_cast<std::size_t>(bounds[b + 1] - bounds[b]);
+      stack.push_back({range.data.subspan(static_cast<std::size_t>(bounds[b]), size),
+                       range.pass - 1});
     }
-    /*
-     * Commented out because it causes errors in the CI environment.
-     ** std::ranges::move(output, arr.begin());
-     */
-    std::move(output.begin(), output.end(), arr.begin());
-    std::cout << "Radix sort complete" << '\n';
   }
+  std::ranges::sort(tasks, std::greater<>{}, [](const Range& r) { return r.data.size(); });
+
+  runWorkStealing(threads, std::move(tasks), [](Range range, auto&) {
+    americanFlagSortPass(range.data, std::identity{}, range.pass);
+  });
+}
+
+template <RadixSortable T>
+void parallelAmericanFlagSort(std::vector<T>& arr, std::size_t threads = 0) {
+  parallelAmericanFlagSort(std::span<T>{arr}, threads);
 }
 
-#endif  // RADIX_SORT_HPP
\ No newline at end of file
+#endif  // RADIX_SORT_HPP
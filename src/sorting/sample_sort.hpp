@@ -0,0 +1,722 @@
+#ifndef SAMPLE_SORT_HPP
+#define SAMPLE_SORT_HPP
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "pdq_sort.hpp"
+#include "quick_sort.hpp"
+#include "sort_observer.hpp"
+#include "sorting_concepts.hpp"
+#include "sorting_parallel.hpp"
+
+// Ranges at or below this size are handed to pdqSort.
+inline constexpr std::ptrdiff_t kSampleSortBaseCase = 4096;
+// At most 2^8 = 256 buckets per level (twice that with equality buckets).
+inline constexpr int kSampleSortMaxLogBuckets = 8;
+// Bytes per block moved by the in-place permutation.
+inline constexpr std::size_t kSampleSortBlockBytes = 2048;
+// Elements pushed through the search tree side by side during classification.
+inline constexpr std::ptrdiff_t kSampleSortClassifyUnroll = 8;
+// Smallest range partitioned cooperatively by all workers.
+inline constexpr std::ptrdiff_t kParallelSampleSortThreshold = std::ptrdiff_t{1} << 16;
+
+template <typename T>
+inline constexpr std::ptrdiff_t kSampleSortBlockSize =
+    std::max<std::ptrdiff_t>(1, static_cast<std::ptrdiff_t>(kSampleSortBlockBytes / sizeof(T)));
+
+/**
+ * @brief Fixed-capacity buffers of one block each, constructed in place so
+ *        the elements only need to be movable
+ */
+template <typename T>
+class SampleSortBuffers {
+ public:
+  SampleSortBuffers() = default;
+  SampleSortBuffers(const SampleSortBuffers&) = delete;
+  SampleSortBuffers& operator=(const SampleSortBuffers&) = delete;
+  ~SampleSortBuffers() { release(); }
+
+  /**
+   * @brief Empties the buffers and makes room for `buckets` of them
+   *
+   * @return Bytes newly allocated; storage is reused when it is big enough
+   */
+  std::size_t reset(std::size_t buckets, std::ptrdiff_t blockSize) {
+    clear();
+    std::size_t capacity = buckets * static_cast<std::size_t>(blockSize);
+    std::size_t allocated = 0;
+    if (capacity > capacity_) {
+      release();
+      data_ = std::allocator<T>{}.allocate(capacity);
+      capacity_ = capacity;
+      allocated = capacity * sizeof(T);
+    }
+    blockSize_ = blockSize;
+    sizes_.assign(buckets, 0);
+    return allocated;
+  }
+
+  std::ptrdiff_t size(std::size_t b) const { return sizes_[b]; }
+  const T& front(std::size_t b) const { return *slot(b); }
+
+  void push(std::size_t b, T&& value) {
+    std::construct_at(slot(b) + sizes_[b]++, std::move(value));
+  }
+
+  /**
+   * @brief Fills the empty buffer b with a whole block moved out of in
+   */
+  template <std::random_access_iterator It>
+  void load(std::size_t b, It in) {
+    std::uninitialized_move_n(in, blockSize_, slot(b));
+    sizes_[b] = blockSize_;
+  }
+
+  /**
+   * @brief Moves the contents of buffer b to out and empties it
+   */
+  template <typename Out>
+  void flush(std::size_t b, Out out) {
+    T* begin = slot(b);
+    std::move(begin, begin + sizes_[b], out);
+    std::destroy_n(begin, sizes_[b]);
+    sizes_[b] = 0;
+  }
+
+  /**
+   * @brief Hands every element of buffer b to put as an rvalue and empties it
+   */
+  template <typename Put>
+  void drain(std::size_t b, Put&& put) {
+    T* begin = slot(b);
+    for (std::ptrdiff_t i = 0; i < sizes_[b]; ++i) {
+      put(std::move(begin[i]));
+    }
+    std::destroy_n(begin, sizes_[b]);
+    sizes_[b] = 0;
+  }
+
+ private:
+  T* slot(std::size_t b) const { return data_ + b * static_cast<std::size_t>(blockSize_); }
+
+  void clear() {
+    for (std::size_t b = 0; b < sizes_.size(); ++b) {
+      std::destroy_n(slot(b), sizes_[b]);
+      sizes_[b] = 0;
+    }
+  }
+
+  void release() {
+    clear();
+    if (data_ != nullptr) {
+      std::allocator<T>{}.deallocate(data_, capacity_);
+    }
+    data_ = nullptr;
+    capacity_ = 0;
+  }
+
+  T* data_ = nullptr;
+  std::size_t capacity_ = 0;
+  std::ptrdiff_t blockSize_ = 0;
+  std::vector<std::ptrdiff_t> sizes_;
+};
+
+/**
+ * @brief Per-thread buffers of the block permutation, kept across levels
+ */
+template <typename T>
+struct SampleSortScratch {
+  explicit SampleSortScratch(std::size_t threads) : buckets(threads), swaps(threads) {}
+
+  std::size_t threads() const { return buckets.size(); }
+
+  std::vector<SampleSortBuffers<T>> buckets;
+  std::vector<SampleSortBuffers<T>> swaps;
+};
+
+/**
+ * @brief Branchless search-tree classifier over sorted, distinct splitters
+ *
+ * The splitters are laid out as an implicit binary tree (Eytzinger order), so
+ * finding the bucket of an element is log2(buckets) steps of
+ * `i = 2 * i + comp(tree[i], x)` with no data-dependent branches. Bucket b
+ * holds the elements in (splitter[b - 1], splitter[b]]. With EqualBuckets,
+ * which callers pick when the sample is full of duplicates, each bucket is
+ * split further into elements less than and equal to its splitter, and the
+ * equal halves never need sorting again. Copyable splitters are copied into
+ * the tree for locality; move-only ones are referenced.
+ */
+template <bool EqualBuckets, typename T, typename Compare>
+class SampleSortClassifier {
+ public:
+  SampleSortClassifier(const std::vector<T>& splitters, Compare comp)
+      : comp_(comp), unique_(splitters.size()) {
+    logLeaves_ = static_cast<int>(std::bit_width(unique_));
+    leaves_ = std::size_t{1} << logLeaves_;
+    auto node = [&](std::size_t rank) -> Node {
+      const T& splitter = splitters[std::min(rank, unique_ - 1)];
+      if constexpr (kCopies) {
+        return splitter;
+      } else {
+        return &splitter;
+      }
+    };
+    tree_.reserve(leaves_);
+    tree_.push_back(node(0));
+    for (std::size_t i = 1; i < leaves_; ++i) {
+      auto level = std::bit_width(i) - 1;
+      auto position = i - (std::size_t{1} << level);
+      tree_.push_back(node((2 * position + 1) * (leaves_ >> (level + 1)) - 1));
+    }
+    if constexpr (EqualBuckets) {
+      upper_.reserve(leaves_);
+      for (std::size_t b = 0; b < leaves_; ++b) {
+        upper_.push_back(node(b));
+      }
+    }
+  }
+
+  std::size_t buckets() const { return EqualBuckets ? 2 * leaves_ : leaves_; }
+
+  std::size_t operator()(const T& value) const {
+    std::size_t index = 1;
+    for (int level = 0; level < logLeaves_; ++level) {
+      index = 2 * index + static_cast<std::size_t>(comp_(at(tree_[index]), value));
+    }
+    return finish(index, value);
+  }
+
+  /**
+   * @brief Calls yield(bucket, it) for every it in [first, last), walking
+   *        kSampleSortClassifyUnroll elements down the tree together so
+   *        their comparisons overlap
+   */
+  template <std::random_access_iterator It, typename Yield>
+  void classify(It first, It last, Yield&& yield) const {
+    for (; last - first >= kSampleSortClassifyUnroll; first += kSampleSortClassifyUnroll) {
+      std::size_t index[kSampleSortClassifyUnroll];
+      std::ranges::fill(index, std::size_t{1});
+      for (int level = 0; level < logLeaves_; ++level) {
+        for (std::ptrdiff_t j = 0; j < kSampleSortClassifyUnroll; ++j) {
+          index[j] = 2 * index[j] + static_cast<std::size_t>(comp_(at(tree_[index[j]]), first[j]));
+        }
+      }
+      for (std::ptrdiff_t j = 0; j < kSampleSortClassifyUnroll; ++j) {
+        yield(finish(index[j], first[j]), first + j);
+      }
+    }
+    for (; first != last; ++first) {
+      yield((*this)(*first), first);
+    }
+  }
+
+ private:
+  static constexpr bool kCopies = std::copyable<T>;
+  using Node = std::conditional_t<kCopies, T, const T*>;
+
+  static const T& at(const Node& node) {
+    if constexpr (kCopies) {
+      return node;
+    } else {
+      return *node;
+    }
+  }
+
+  std::size_t finish(std::size_t index, const T& value) const {
+    std::size_t bucket = index - leaves_;
+    if constexpr (EqualBuckets) {
+      bucket = 2 * bucket + (static_cast<std::size_t>(bucket < unique_) &
+                             static_cast<std::size_t>(!comp_(value, at(upper_[bucket]))));
+    }
+    return bucket;
+  }
+
+  Compare comp_;
+  std::size_t unique_;
+  int logLeaves_;
+  std::size_t leaves_;
+  std::vector<Node> tree_;
+  std::vector<Node> upper_;
+};
+
+/**
+ * @brief Distributes [first, last) into the buckets of classifier in place,
+ *        using every thread of scratch
+ *
+ * [first, first + classified) holds the elements to classify and the rest is
+ * the room left by the splitters, which go back in with their buckets.
+ * Besides SampleSortClassifier, any classifier providing buckets(),
+ * operator()(value) and classify(first, last, yield) can drive it.
+ *
+ * 1. Each thread classifies its stripe of whole blocks into one buffer
+ *    block per bucket; a full buffer is written back over the stripe's
+ *    already-read prefix, so every stripe becomes a run of full,
+ *    single-bucket blocks followed by empty space.
+ * 2. Bucket sizes give every bucket a block-aligned region, and the full
+ *    blocks inside each region are moved to its front.
+ * 3. Threads take full blocks from the back of a region and swap them into
+ *    the write slot of their bucket until every block is in its own region.
+ *    Each bucket's read and write slots are guarded by a mutex, taken once
+ *    per block.
+ * 4. The unaligned bucket edges are filled from the partial buffers, from
+ *    the block that spilled past the end of the range and from the last
+ *    block of the previous bucket where it overhangs.
+ *
+ * The only extra memory is a buffer block per bucket and two swap blocks per
+ * thread, independent of the input size.
+ *
+ * @return Bucket boundaries, as offsets from first
+ */
+template <std::random_access_iterator It, typename Classifier, SortObserver Observer>
+std::vector<std::ptrdiff_t> sampleSortPartition(It first, It last, std::ptrdiff_t classified,
+                                                const Classifier& classifier,
+                                                std::vector<std::iter_value_t<It>>& splitters,
+                                                SampleSortScratch<std::iter_value_t<It>>& scratch,
+                                                Observer observer) {
+  using T = std::iter_value_t<It>;
+  constexpr std::ptrdiff_t kBlock = kSampleSortBlockSize<T>;
+  const std::size_t threads = scratch.threads();
+  const std::size_t buckets = classifier.buckets();
+  const std::ptrdiff_t n = last - first;
+  auto blocksOf = [](std::ptrdiff_t elements) { return (elements + kBlock - 1) / kBlock; };
+  const std::ptrdiff_t stripeBlocks = blocksOf(classified);
+
+  std::vector<std::ptrdiff_t> stripeBegin(threads + 1);
+  for (std::size_t t = 0; t <= threads; ++t) {
+    stripeBegin[t] = static_cast<std::ptrdiff_t>(
+        chunkBounds(static_cast<std::size_t>(stripeBlocks), threads, t).first);
+  }
+  std::vector<std::ptrdiff_t> stripeWritten(threads);
+  std::vector<std::vector<std::ptrdiff_t>> counts(threads, std::vector<std::ptrdiff_t>(buckets));
+  std::vector<std::size_t> moves(threads);
+  std::size_t allocated = 0;
+  for (std::size_t t = 0; t < threads; ++t) {
+    allocated += scratch.buckets[t].reset(buckets, kBlock);
+    allocated += scratch.swaps[t].reset(2, kBlock);
+  }
+  if (allocated > 0) {
+    observer.onAllocate(allocated);
+  }
+
+  parallelFor(threads, [&](std::size_t t) {
+    auto& local = scratch.buckets[t];
+    auto& count = counts[t];
+    It begin = first + std::min(stripeBegin[t] * kBlock, classified);
+    It end = first + std::min(stripeBegin[t + 1] * kBlock, classified);
+    It write = begin;
+    classifier.classify(begin, end, [&](std::size_t b, It element) {
+      if (local.size(b) == kBlock) {
+        local.flush(b, write);
+        write += kBlock;
+        count[b] += kBlock;
+      }
+      local.push(b, std::move(*element));
+    });
+    for (std::size_t b = 0; b < buckets; ++b) {
+      count[b] += local.size(b);
+    }
+    stripeWritten[t] = (write - begin) / kBlock;
+    moves[t] += static_cast<std::size_t>((end - begin) + (write - begin));
+  });
+
+  std::vector<std::ptrdiff_t> bounds(buckets + 1);
+  std::vector<std::size_t> splitterBuckets;
+  for (const T& splitter : splitters) {
+    splitterBuckets.push_back(classifier(splitter));
+    ++bounds[splitterBuckets.back() + 1];
+  }
+  for (std::size_t b = 0; b < buckets; ++b) {
+    for (std::size_t t = 0; t < threads; ++t) {
+      bounds[b + 1] += counts[t][b];
+    }
+    bounds[b + 1] += bounds[b];
+  }
+
+  auto isFull = [&](std::ptrdiff_t block) {
+    if (block >= stripeBlocks) {
+      return false;
+    }
+    auto t = std::upper_bound(stripeBegin.begin(), stripeBegin.end(), block) - stripeBegin.begin();
+    return block < stripeBegin[t - 1] + stripeWritten[t - 1];
+  };
+  struct BucketSlots {
+    std::mutex mutex;
+    std::ptrdiff_t write = 0;
+    std::ptrdiff_t read = 0;
+  };
+  std::vector<BucketSlots> slots(buckets);
+  parallelFor(threads, [&](std::size_t t) {
+    auto [bucketBegin, bucketEnd] = chunkBounds(buckets, threads, t);
+    for (std::size_t b = bucketBegin; b < bucketEnd; ++b) {
+      std::ptrdiff_t low = blocksOf(bounds[b]);
+      std::ptrdiff_t high = blocksOf(bounds[b + 1]);
+      slots[b].write = low;
+      for (;;) {
+        while (low < high && isFull(low)) {
+          ++low;
+        }
+        while (low < high && !isFull(high - 1)) {
+          --high;
+        }
+        if (low == high) {
+          break;
+        }
+        --high;
+        std::move(first + high * kBlock, first + (high + 1) * kBlock, first + low * kBlock);
+        ++low;
+        moves[t] += kBlock;
+      }
+      slots[b].read = low;
+    }
+  });
+
+  std::vector<T> overflow;
+  std::size_t overflowBucket = buckets;
+  parallelFor(threads, [&](std::size_t t) {
+    auto& swap = scratch.swaps[t];
+    for (std::size_t i = 0; i < buckets; ++i) {
+      std::size_t source = (t * buckets / threads + i) % buckets;
+      for (;;) {
+        {
+          std::scoped_lock lock(slots[source].mutex);
+          if (slots[source].read <= slots[source].write) {
+            break;
+          }
+          swap.load(0, first + --slots[source].read * kBlock);
+        }
+        std::size_t current = 0;
+        for (;;) {
+          std::size_t dest = classifier(swap.front(current));
+          std::ptrdiff_t slot;
+          bool occupied;
+          {
+            std::scoped_lock lock(slots[dest].mutex);
+            slot = slots[dest].write++;
+            occupied = slot < slots[dest].read;
+          }
+          moves[t] += 2 * kBlock;
+          It out = first + slot * kBlock;
+          if (occupied) {
+            swap.load(1 - current, out);
+            swap.flush(current, out);
+            current = 1 - current;
+            continue;
+          }
+          if ((slot + 1) * kBlock > n) {
+            overflow.reserve(kBlock);
+            swap.flush(current, std::back_inserter(overflow));
+            overflowBucket = dest;
+          } else {
+            swap.flush(current, out);
+          }
+          break;
+        }
+      }
+    }
+  });
+
+  auto writtenEnd = [&](std::size_t b) {
+    return slots[b].write * kBlock - (b == overflowBucket ? kBlock : 0);
+  };
+  std::vector<std::vector<T>> tails(buckets);
+  parallelFor(threads, [&](std::size_t t) {
+    auto [bucketBegin, bucketEnd] = chunkBounds(buckets, threads, t);
+    for (std::size_t b = bucketBegin; b < bucketEnd; ++b) {
+      auto tailBegin = std::max(bounds[b + 1], blocksOf(bounds[b]) * kBlock);
+      for (auto i = tailBegin; i < writtenEnd(b); ++i) {
+        tails[b].push_back(std::move(first[i]));
+      }
+    }
+  });
+  parallelFor(threads, [&](std::size_t t) {
+    auto [bucketBegin, bucketEnd] = chunkBounds(buckets, threads, t);
+    std::size_t splitter = 0;
+    for (std::size_t b = bucketBegin; b < bucketEnd; ++b) {
+      It out = first + bounds[b];
+      It headEnd = first + std::min(blocksOf(bounds[b]) * kBlock, bounds[b + 1]);
+      It gapBegin = first + writtenEnd(b);
+      auto put = [&](T&& value) {
+        if (out == headEnd) {
+          out = gapBegin;
+        }
+        *out = std::move(value);
+        ++out;
+        ++moves[t];
+      };
+      for (T& value : tails[b]) {
+        put(std::move(value));
+      }
+      if (b == overflowBucket) {
+        for (T& value : overflow) {
+          put(std::move(value));
+        }
+      }
+      for (auto& local : scratch.buckets) {
+        local.drain(b, put);
+      }
+      while (splitter < splitters.size() && splitterBuckets[splitter] < b) {
+        ++splitter;
+      }
+      if (splitter < splitters.size() && splitterBuckets[splitter] == b) {
+        put(std::move(splitters[splitter]));
+      }
+    }
+  });
+
+  std::size_t totalMoves = 0;
+  for (std::size_t count : moves) {
+    totalMoves += count;
+  }
+  observer.onMove(totalMoves);
+  return bounds;
+}
+
+struct SampleSortSplit {
+  std::vector<std::ptrdiff_t> bounds;
+  // Odd buckets hold elements equal to a splitter and are already sorted.
+  bool equalBuckets;
+};
+
+/**
+ * @brief One samplesort level: draws a random sample, sorts it, moves
+ *        evenly spaced distinct splitters out of the range and partitions
+ *        the rest around them with sampleSortPartition
+ *
+ * The sample holds about 0.2 log2(n) elements per bucket. If the chosen
+ * splitters contain duplicates, equality buckets are used instead, so heavy
+ * keys are finished in this level.
+ */
+template <std::random_access_iterator It, typename Compare, SortObserver Observer>
+SampleSortSplit sampleSortStep(It first, It last, Compare comp,
+                               SampleSortScratch<std::iter_value_t<It>>& scratch,
+                               Observer observer) {
+  using T = std::iter_value_t<It>;
+  auto n = last - first;
+  int logBuckets = std::clamp(
+      static_cast<int>(std::bit_width(static_cast<std::size_t>(n / kSampleSortBaseCase))), 1,
+      kSampleSortMaxLogBuckets);
+  auto buckets = std::ptrdiff_t{1} << logBuckets;
+  auto oversampling =
+      std::max<std::ptrdiff_t>(1, static_cast<std::ptrdiff_t>(std::bit_width(
+                                      static_cast<std::size_t>(n))) / 5);
+  auto sampleSize = std::min(buckets * oversampling - 1, n / 2);
+
+  std::mt19937_64 random(static_cast<std::uint64_t>(n));
+  for (std::ptrdiff_t i = 0; i < sampleSize; ++i) {
+    std::iter_swap(first + i,
+                   first + i + static_cast<std::ptrdiff_t>(
+                                   random() % static_cast<std::uint64_t>(n - i)));
+  }
+  observer.onMove(3 * static_cast<std::size_t>(sampleSize));
+  pdqSortImpl(first, first + sampleSize, comp, observer);
+
+  std::vector<T> splitters;
+  std::vector<std::ptrdiff_t> holes;
+  for (std::ptrdiff_t i = 1; i < buckets; ++i) {
+    auto position = i * (sampleSize + 1) / buckets - 1;
+    if (!splitters.empty() && !comp(splitters.back(), first[position])) {
+      continue;
+    }
+    splitters.push_back(std::move(first[position]));
+    holes.push_back(position);
+  }
+  // Close the holes with elements from the back of the range.
+  It end = last;
+  for (auto hole = holes.rbegin(); hole != holes.rend(); ++hole) {
+    --end;
+    if (first + *hole != end) {
+      first[*hole] = std::move(*end);
+    }
+  }
+
+  bool equalBuckets = splitters.size() + 1 < static_cast<std::size_t>(buckets);
+  std::vector<std::ptrdiff_t> bounds;
+  if (equalBuckets) {
+    SampleSortClassifier<true, T, Compare> classifier(splitters, comp);
+    bounds = sampleSortPartition(first, last, end - first, classifier, splitters, scratch,
+                                 observer);
+  } else {
+    SampleSortClassifier<false, T, Compare> classifier(splitters, comp);
+    bounds = sampleSortPartition(first, last, end - first, classifier, splitters, scratch,
+                                 observer);
+  }
+  return {std::move(bounds), equalBuckets};
+}
+
+/**
+ * @brief Sequential samplesort recursion; ranges at or below
+ *        kSampleSortBaseCase, and ranges still unsorted after depthLimit
+ *        levels, are finished by pdqSort
+ */
+template <std::random_access_iterator It, typename Compare,
+          SortObserver Observer = NullSortObserver>
+void sampleSortLoop(It first, It last, Compare comp, int depthLimit,
+                    SampleSortScratch<std::iter_value_t<It>>& scratch, Observer observer = {},
+                    std::size_t depth = 0) {
+  if (last - first <= kSampleSortBaseCase || depthLimit == 0) {
+    pdqSortImpl(first, last, comp, observer, depth);
+    return;
+  }
+  observer.onRecurse(depth);
+  auto [bounds, equalBuckets] = sampleSortStep(first, last, comp, scratch, observer);
+  for (std::size_t b = 0; b + 1 < bounds.size(); ++b) {
+    if (!equalBuckets || b % 2 == 0) {
+      sampleSortLoop(first + bounds[b], first + bounds[b + 1], comp, depthLimit - 1, scratch,
+                     observer, depth + 1);
+    }
+  }
+}
+
+/**
+ * @brief Finishes [first, last) in one pass if it is already sorted or
+ *        strictly descending
+ *
+ * @return Whether the range is now sorted
+ */
+template <std::random_access_iterator It, typename Compare,
+          SortObserver Observer = NullSortObserver>
+bool sampleSortPresorted(It first, It last, Compare comp, Observer observer = {}) {
+  if (last - first < 2) {
+    return true;
+  }
+  if (comp(*std::next(first), *first)) {
+    It i = std::next(first);
+    while (++i != last && comp(*i, *std::prev(i))) {
+    }
+    if (i != last) {
+      return false;
+    }
+    observer.onMove(static_cast<std::size_t>(last - first));
+    std::reverse(first, last);
+    return true;
+  }
+  It i = std::next(first);
+  while (++i != last && !comp(*i, *std::prev(i))) {
+  }
+  return i == last;
+}
+
+/**
+ * @brief In-place super-scalar samplesort of [first, last) (IPS4o)
+ *
+ * Every level splits the range into up to 256 buckets with a branchless
+ * search-tree classifier and moves them into place block by block, so the
+ * extra memory is a few hundred kilobytes of buffers however large the
+ * input. Move-only element types are supported. Sorted and strictly
+ * descending inputs are detected up front and take n - 1 comparisons.
+ * Expected O(n log n); inputs that defeat the sampling fall back to pdqSort.
+ */
+template <std::random_access_iterator It, typename Compare = std::ranges::less,
+          typename Proj = std::identity, SortObserver Observer = NullSortObserver>
+  requires SortableIterator<It, Compare, Proj>
+void sampleSort(It first, It last, Compare comp = {}, Proj proj = {}, Observer observer = {}) {
+  auto less = observeComparisons(projectedComparator(comp, proj), observer);
+  if (sampleSortPresorted(first, last, less, observer)) {
+    return;
+  }
+  SampleSortScratch<std::iter_value_t<It>> scratch(1);
+  sampleSortLoop(first, last, less, introSortDepthLimit(first, last), scratch, observer);
+}
+
+template <std::ranges::random_access_range R, typename Compare = std::ranges::less,
+          typename Proj = std::identity, SortObserver Observer = NullSortObserver>
+  requires SortableRange<R, Compare, Proj>
+void sampleSort(R&& range, Compare comp = {}, Proj proj = {}, Observer observer = {}) {
+  auto first = std::ranges::begin(range);
+  sampleSort(first, std::ranges::next(first, std::ranges::end(range)), comp, proj, observer);
+}
+
+template <Pivotable T, SortObserver Observer = NullSortObserver>
+void sampleSort(std::vector<T>& arr, Observer observer = {}) {
+  sampleSort(arr.begin(), arr.end(), std::less<>{}, std::identity{}, observer);
+}
+
+/**
+ * @brief Parallel in-place samplesort over [first, last), for inputs too large
+ *        to spare the O(n) buffer of parallelMergeSort or radixSort
+ *
+ * Ranges larger than one worker's share are classified and permuted by all
+ * threads together; the resulting buckets are then sorted sequentially on a
+ * work-stealing scheduler, largest first. Extra memory is O(threads) blocks
+ * per bucket.
+ *
+ * @param threads Number of worker threads; 0 uses the hardware concurrency
+ */
+template <std::random_access_iterator It, typename Compare>
+void parallelSampleSort(It first, It last, Compare comp, std::size_t threads = 0) {
+  using T = std::iter_value_t<It>;
+  threads = resolveThreadCount(threads);
+  auto n = last - first;
+  if (sampleSortPresorted(first, last, comp)) {
+    return;
+  }
+  if (threads == 1 || n <= kParallelSampleSortThreshold) {
+    SampleSortScratch<T> scratch(1);
+    sampleSortLoop(first, last, comp, introSortDepthLimit(first, last), scratch);
+    return;
+  }
+
+  struct Range {
+    It first;
+    It last;
+    int depthLimit;
+  };
+  auto splitThreshold =
+      std::max(n / static_cast<std::ptrdiff_t>(threads), kParallelSampleSortThreshold);
+  SampleSortScratch<T> scratch(threads);
+  std::vector<Range> stack{{first, last, introSortDepthLimit(first, last)}};
+  std::vector<Range> tasks;
+  while (!stack.empty()) {
+    Range range = stack.back();
+    stack.pop_back();
+    if (range.last - range.first <= splitThreshold || range.depthLimit == 0) {
+      if (range.last - range.first > 1) {
+        tasks.push_back(range);
+      }
+      continue;
+    }
+    auto [bounds, equalBuckets] =
+        sampleSortStep(range.first, range.last, comp, scratch, NullSortObserver{});
+    for (std::size_t b = 0; b + 1 < bounds.size(); ++b) {
+      if (!equalBuckets || b % 2 == 0) {
+        stack.push_back({range.first + bounds[b], range.first + bounds[b + 1],
+                         range.depthLimit - 1});
+      }
+    }
+  }
+  std::ranges::sort(tasks, std::greater<>{}, [](const Range& r) { return r.last - r.first; });
+
+  runWorkStealing(threads, std::move(tasks), [&](Range range, auto&) {
+    SampleSortScratch<T> local(1);
+    sampleSortLoop(range.first, range.last, comp, range.depthLimit, local);
+  });
+}
+
+template <std::ranges::random_access_range R, typename Compare = std::ranges::less,
+          typename Proj = std::identity>
+  requires SortableRange<R, Compare, Proj>
+void parallelSampleSort(R&& range, Compare comp = {}, Proj proj = {}, std::size_t threads = 0) {
+  auto first = std::ranges::begin(range);
+  parallelSampleSort(first, std::ranges::next(first, std::ranges::end(range)),
+                     projectedComparator(comp, proj), threads);
+}
+
+template <Pivotable T>
+void parallelSampleSort(std::vector<T>& arr, std::size_t threads = 0) {
+  parallelSampleSort(arr.begin(), arr.end(), std::less<>{}, threads);
+}
+
+#endif  // SAMPLE_SORT_HPP
@@ -0,0 +1,238 @@
+#ifndef SELECTION_HPP
+#define SELECTION_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+#include "insertion_sort.hpp"
+#include "quick_sort.hpp"
+#include "sort_observer.hpp"
+#include "sorting_concepts.hpp"
+
+// Ranges at or below this size are finished with insertion sort.
+inline constexpr std::ptrdiff_t kSelectionInsertionThreshold = 24;
+// Ranges above this size pick their pivot with Floyd-Rivest sampling.
+inline constexpr std::ptrdiff_t kFloydRivestThreshold = 600;
+
+/**
+ * @brief Median-of-medians selection: places the element of rank nth - first
+ *        at nth, smaller-or-equal elements before it and greater-or-equal
+ *        elements after it, in guaranteed O(n) comparisons
+ *
+ * The pivot is the median of the medians of groups of five, which discards
+ * at least 30% of the range per round.
+ */
+template <std::random_access_iterator It, typename Compare,
+          SortObserver Observer = NullSortObserver>
+void medianOfMediansSelect(It first, It nth, It last, Compare comp, Observer observer = {}) {
+  while (last - first > kSelectionInsertionThreshold) {
+    It medians = first;
+    for (It group = first; group < last; group += std::min<std::ptrdiff_t>(5, last - group)) {
+      It groupEnd = group + std::min<std::ptrdiff_t>(5, last - group);
+      insertionSortImpl(group, groupEnd, comp, observer);
+      observer.onSwap();
+      std::iter_swap(medians++, group + (groupEnd - group) / 2);
+    }
+    It median = first + (medians - first) / 2;
+    medianOfMediansSelect(first, median, medians, comp, observer);
+    observer.onSwap();
+    std::iter_swap(first, median);
+    It pivot = partitionRange(first, last, comp, observer);
+    if (pivot == nth) {
+      return;
+    }
+    if (nth < pivot) {
+      last = pivot;
+    } else {
+      first = std::next(pivot);
+    }
+  }
+  insertionSortImpl(first, last, comp, observer);
+}
+
+/**
+ * @brief Introselect driver on the quicksort partition kernel
+ *
+ * Large ranges take their pivot from Floyd-Rivest sampling: elements spread
+ * evenly over the range are gathered into a small window around nth, and a
+ * recursive selection inside it makes the pivot land within a few standard
+ * deviations of the target rank, so most of the range is discarded after one
+ * partition. Medium ranges use the
+ * quicksort pivot. Once depthLimit partitions have failed to finish, the rest
+ * is handed to median-of-medians, bounding the worst case at O(n).
+ */
+template <std::random_access_iterator It, typename Compare,
+          SortObserver Observer = NullSortObserver>
+void introSelect(It first, It nth, It last, Compare comp, int depthLimit,
+                 Observer observer = {}) {
+  while (last - first > kSelectionInsertionThreshold) {
+    if (depthLimit-- == 0) {
+      medianOfMediansSelect(first, nth, last, comp, observer);
+      return;
+    }
+    auto n = last - first;
+    if (n > kFloydRivestThreshold) {
+      auto k = static_cast<double>(nth - first);
+      double size = static_cast<double>(n);
+      double z = std::log(size);
+      double sample = 0.5 * std::exp(2.0 * z / 3.0);
+      double deviation = 0.5 * std::sqrt(z * sample * (size - sample) / size) *
+                         (k < size / 2 ? -1.0 : 1.0);
+      auto windowFirst = static_cast<std::ptrdiff_t>(
+          std::max(0.0, std::floor(k - k * sample / size + deviation)));
+      auto windowLast = static_cast<std::ptrdiff_t>(
+          std::min(size, std::floor(k + (size - k) * sample / size + deviation) + 1));
+      windowFirst = std::min(windowFirst, nth - first);
+      windowLast = std::max(windowLast, nth - first + 1);
+      // Fill the window with elements drawn evenly from the whole range so
+      // presorted inputs still yield a representative sample.
+      auto windowSize = windowLast - windowFirst;
+      for (decltype(n) i = 0; i < windowSize; ++i) {
+        std::iter_swap(first + windowFirst + i, first + i * n / windowSize);
+      }
+      observer.onMove(2 * static_cast<std::size_t>(windowSize));
+      introSelect(first + windowFirst, nth, first + windowLast, comp, depthLimit, observer);
+      observer.onSwap();
+      std::iter_swap(first, nth);
+    } else {
+      choosePivot(first, last, comp, observer);
+    }
+    It pivot = partitionRange(first, last, comp, observer);
+    if (pivot == nth) {
+      return;
+    }
+    if (nth < pivot) {
+      last = pivot;
+    } else {
+      first = std::next(pivot);
+    }
+  }
+  insertionSortImpl(first, last, comp, observer);
+}
+
+/**
+ * @brief Rearranges [first, last) so that *nth is the element a full sort
+ *        would put there, with no element before it greater and no element
+ *        after it less, like std::ranges::nth_element
+ *
+ * Expected O(n) with Floyd-Rivest and introselect pivots; O(n) worst case
+ * through the median-of-medians fallback.
+ */
+template <std::random_access_iterator It, typename Compare = std::ranges::less,
+          typename Proj = std::identity, SortObserver Observer = NullSortObserver>
+  requires SortableIterator<It, Compare, Proj>
+void nthElement(It first, It nth, It last, Compare comp = {}, Proj proj = {},
+                Observer observer = {}) {
+  if (nth == last) {
+    return;
+  }
+  introSelect(first, nth, last, observeComparisons(projectedComparator(comp, proj), observer),
+              introSortDepthLimit(first, last), observer);
+}
+
+template <std::ranges::random_access_range R, typename Compare = std::ranges::less,
+          typename Proj = std::identity, SortObserver Observer = NullSortObserver>
+  requires SortableRange<R, Compare, Proj>
+void nthElement(R&& range, std::ranges::iterator_t<R> nth, Compare comp = {}, Proj proj = {},
+                Observer observer = {}) {
+  auto first = std::ranges::begin(range);
+  nthElement(first, nth, std::ranges::next(first, std::ranges::end(range)), comp, proj, observer);
+}
+
+template <Pivotable T, SortObserver Observer = NullSortObserver>
+void nthElement(std::vector<T>& arr, size_t nth, Observer observer = {}) {
+  nthElement(arr.begin(), arr.begin() + static_cast<std::ptrdiff_t>(std::min(nth, arr.size())),
+             arr.end(), std::less<>{}, std::identity{}, observer);
+}
+
+/**
+ * @brief Sorts the middle - first smallest elements of [first, last) into
+ *        [first, middle), leaving the rest in unspecified order, like
+ *        std::ranges::partial_sort
+ *
+ * Selects with nthElement and then introsorts only the prefix, so the cost
+ * is O(n + k log k) for k = middle - first rather than O(n log k).
+ */
+template <std::random_access_iterator It, typename Compare = std::ranges::less,
+          typename Proj = std::identity, SortObserver Observer = NullSortObserver>
+  requires SortableIterator<It, Compare, Proj>
+void partialSort(It first, It middle, It last, Compare comp = {}, Proj proj = {},
+                 Observer observer = {}) {
+  if (first == middle) {
+    return;
+  }
+  nthElement(first, std::prev(middle), last, comp, proj, observer);
+  quickSort(first, std::prev(middle), comp, proj, observer);
+}
+
+template <std::ranges::random_access_range R, typename Compare = std::ranges::less,
+          typename Proj = std::identity, SortObserver Observer = NullSortObserver>
+  requires SortableRange<R, Compare, Proj>
+void partialSort(R&& range, std::ranges::iterator_t<R> middle, Compare comp = {},
+                 Proj proj = {}, Observer observer = {}) {
+  auto first = std::ranges::begin(range);
+  partialSort(first, middle, std::ranges::next(first, std::ranges::end(range)), comp, proj,
+              observer);
+}
+
+template <Pivotable T, SortObserver Observer = NullSortObserver>
+void partialSort(std::vector<T>& arr, size_t k, Observer observer = {}) {
+  partialSort(arr.begin(), arr.begin() + static_cast<std::ptrdiff_t>(std::min(k, arr.size())),
+              arr.end(), std::less<>{}, std::identity{}, observer);
+}
+
+/**
+ * @brief The k elements of range that come first under comp (the k largest
+ *        by default), in sorted order, leaving range untouched
+ *
+ * Streams the input through a buffer of 2k candidates. Whenever the buffer
+ * fills up it is cut back to its best k with nthElement, and the k-th best
+ * becomes a threshold that rejects most later elements with a single
+ * comparison. Runs in expected O(n + k log k) time with O(k) extra space, so
+ * picking the top 1000 of 10^8 values never copies the input.
+ */
+template <std::ranges::input_range R, typename Compare = std::ranges::greater,
+          typename Proj = std::identity>
+  requires std::indirect_strict_weak_order<Compare,
+                                           std::projected<std::ranges::iterator_t<R>, Proj>> &&
+           std::copyable<std::ranges::range_value_t<R>>
+std::vector<std::ranges::range_value_t<R>> topK(R&& range, std::size_t k, Compare comp = {},
+                                                Proj proj = {}) {
+  std::vector<std::ranges::range_value_t<R>> best;
+  if (k == 0) {
+    return best;
+  }
+  auto less = projectedComparator(comp, proj);
+  auto capacity = 2 * k;
+  best.reserve(std::min<std::size_t>(capacity, 1 << 20));
+  bool hasThreshold = false;
+  auto keepBest = [&] {
+    auto kth = best.begin() + static_cast<std::ptrdiff_t>(k - 1);
+    introSelect(best.begin(), kth, best.end(), less, introSortDepthLimit(best.begin(), best.end()));
+    best.erase(kth + 1, best.end());
+  };
+  for (auto&& value : range) {
+    if (hasThreshold && !less(value, best[k - 1])) {
+      continue;
+    }
+    best.push_back(value);
+    if (best.size() == capacity) {
+      keepBest();
+      hasThreshold = true;
+    }
+  }
+  if (best.size() > k) {
+    keepBest();
+  }
+  quickSort(best.begin(), best.end(), less);
+  return best;
+}
+
+#endif  // SELECTION_HPP
@@ -2,32 +2,49 @@
 #define SHELL_SORT_HPP
 
 #include <concepts>
-#include <iostream>
+#include <functional>
+#include <iterator>
 #include <ranges>
 #include <span>
+#include <utility>
 #include <vector>
 
+#include "sort_observer.hpp"
 #include "sorting_concepts.hpp"
 
-template <Sortable T>
-void shellSort(std::vector<T>& arr) {
-  std::cout << "Starting shellSort with array size: " << arr.size() << '\n';
-  std::span s{arr};
-  size_t n = s.size();
+template <std::random_access_iterator It, typename Compare = std::ranges::less,
+          typename Proj = std::identity, SortObserver Observer = NullSortObserver>
+  requires SortableIterator<It, Compare, Proj>
+void shellSort(It first, It last, Compare comp = {}, Proj proj = {}, Observer observer = {}) {
+  auto less = observeComparisons(projectedComparator(comp, proj), observer);
+  auto n = last - first;
 
-  for (size_t gap = n / 2; gap > 0; gap /= 2) {
-    std::cout << "Current gap size: " << gap << '\n';
-    for (size_t i = gap; i < n; i++) {
-      T temp = std::move(s[i]);
-      size_t j = i;
-      for (; j >= gap && s[j - gap] > temp; j -= gap) {
-        std::cout << "Moving element from " << j - gap << " to " << j << '\n';
-        s[j] = std::move(s[j - gap]);
+  std::size_t pass = 0;
+  for (auto gap = n / 2; gap > 0; gap /= 2) {
+    observer.onRecurse(++pass);
+    for (auto i = gap; i < n; i++) {
+      auto temp = std::move(first[i]);
+      auto j = i;
+      for (; j >= gap && less(temp, first[j - gap]); j -= gap) {
+        first[j] = std::move(first[j - gap]);
       }
-      s[j] = std::move(temp);
+      first[j] = std::move(temp);
+      observer.onMove(static_cast<std::size_t>((i - j) / gap) + 2);
     }
   }
-  std::cout << "Shell sort complete" << '\n';
 }
 
-#endif  // SHELL_SORT_HPP
\ No newline at end of file
+template <std::ranges::random_access_range R, typename Compare = std::ranges::less,
+          typename Proj = std::identity, SortObserver Observer = NullSortObserver>
+  requires SortableRange<R, Compare, Proj>
+void shellSort(R&& range, Compare comp = {}, Proj proj = {}, Observer observer = {}) {
+  auto first = std::ranges::begin(range);
+  shellSort(first, std::ranges::next(first, std::ranges::end(range)), comp, proj, observer);
+}
+
+template <Sortable T, SortObserver Observer = NullSortObserver>
+void shellSort(std::vector<T>& arr, Observer observer = {}) {
+  shellSort(arr.begin(), arr.end(), std::less<>{}, std::identity{}, observer);
+}
+
+#endif  // SHELL_SORT_HPP
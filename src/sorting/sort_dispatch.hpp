@@ -0,0 +1,447 @@
+#ifndef SORT_DISPATCH_HPP
+#define SORT_DISPATCH_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "merge_sort.hpp"
+#include "pdq_sort.hpp"
+#include "power_sort.hpp"
+#include "radix_sort.hpp"
+#include "sample_sort.hpp"
+#include "sorting_concepts.hpp"
+#include "sorting_network.hpp"
+
+namespace clavis {
+
+// Ranges below this size skip the presortedness and duplicate probe.
+inline constexpr std::ptrdiff_t kSortProbeMinSize = 512;
+// Number of evenly spaced windows the probe looks at for runs.
+inline constexpr std::ptrdiff_t kSortProbeWindows = 32;
+// Consecutive elements in each probe window.
+inline constexpr std::ptrdiff_t kSortProbeWindowSize = 8;
+// Evenly spaced elements the probe sorts to estimate duplicate density.
+inline constexpr std::ptrdiff_t kSortProbeSamples = 64;
+// Random elements each calibration measurement sorts, in slices of the size
+// being measured.
+inline constexpr std::size_t kSortCalibrationElements = std::size_t{1} << 18;
+
+/**
+ * @brief The algorithm clavis::sort ran
+ */
+enum class SortAlgorithm {
+  kSmallSort,
+  kPdqSort,
+  kPowerSort,
+  kRadixSort,
+  kParallelSampleSort,
+  kParallelRadixSort,
+  kParallelMergeSort,
+};
+
+/**
+ * @brief Caller requirements for clavis::sort
+ */
+struct SortOptions {
+  // Keep equal elements in their input order.
+  bool stable = false;
+  // Worker threads for large inputs; 1 stays on the calling thread and 0
+  // uses the hardware concurrency.
+  std::size_t threads = 1;
+};
+
+/**
+ * @brief Machine-dependent cut-overs clavis::sort decides by
+ *
+ * The sizes come from calibrateSortThresholds; the probe fractions are
+ * properties of the algorithms rather than of the machine and keep their
+ * defaults unless set by hand.
+ */
+struct SortThresholds {
+  // Radix sort replaces comparison sorts from this many 4-byte keys; wider
+  // keys need proportionally more elements since they take more passes.
+  std::ptrdiff_t radixMinSize = 512;
+  // Inputs of at least this size use the parallel sorts when threads != 1.
+  std::ptrdiff_t parallelMinSize = std::ptrdiff_t{1} << 17;
+  // Share of ascending (or descending) neighbours in the probe windows from
+  // which the input counts as presorted and goes to powersort.
+  double presortedFraction = 0.9;
+  // Share of equal neighbours in the sorted probe sample from which the
+  // input counts as duplicate-heavy and stays with pdqsort.
+  double duplicateFraction = 0.5;
+
+  bool operator==(const SortThresholds&) const = default;
+};
+
+/**
+ * @brief What the probe saw of an input
+ */
+struct SortProbe {
+  double ascending = 0;
+  double descending = 0;
+  double duplicates = 0;
+};
+
+/**
+ * @brief Estimates how presorted and how duplicate-heavy [first, last) is
+ *
+ * Compares neighbours inside kSortProbeWindows evenly spaced windows and
+ * counts equal neighbours among kSortProbeSamples evenly spaced elements
+ * by sorting iterators to them, so the probe costs a few hundred
+ * comparisons and moves no elements. Requires at least kSortProbeSamples
+ * elements.
+ */
+template <std::random_access_iterator It, typename Compare>
+SortProbe probeSortInput(It first, It last, Compare comp) {
+  auto n = last - first;
+  std::ptrdiff_t ascending = 0;
+  std::ptrdiff_t descending = 0;
+  for (std::ptrdiff_t w = 0; w < kSortProbeWindows; ++w) {
+    It window = first + w * (n - kSortProbeWindowSize) / (kSortProbeWindows - 1);
+    for (std::ptrdiff_t i = 1; i < kSortProbeWindowSize; ++i) {
+      if (comp(window[i], window[i - 1])) {
+        ++descending;
+      } else if (comp(window[i - 1], window[i])) {
+        ++ascending;
+      }
+    }
+  }
+
+  std::array<It, kSortProbeSamples> samples;
+  for (std::ptrdiff_t s = 0; s < kSortProbeSamples; ++s) {
+    samples[s] = first + s * (n - 1) / (kSortProbeSamples - 1);
+  }
+  std::ranges::sort(samples, [&comp](It a, It b) { return comp(*a, *b); });
+  std::ptrdiff_t duplicates = 0;
+  for (std::ptrdiff_t s = 1; s < kSortProbeSamples; ++s) {
+    duplicates += !comp(*samples[s - 1], *samples[s]);
+  }
+
+  // Equal neighbours count as both ascending and descending.
+  double pairs = static_cast<double>(kSortProbeWindows * (kSortProbeWindowSize - 1));
+  double equal = pairs - static_cast<double>(ascending + descending);
+  return {(static_cast<double>(ascending) + equal) / pairs,
+          (static_cast<double>(descending) + equal) / pairs,
+          static_cast<double>(duplicates) / static_cast<double>(kSortProbeSamples - 1)};
+}
+
+namespace detail {
+
+struct SortThresholdStore {
+  std::atomic<std::ptrdiff_t> radixMinSize;
+  std::atomic<std::ptrdiff_t> parallelMinSize;
+  std::atomic<double> presortedFraction;
+  std::atomic<double> duplicateFraction;
+};
+
+inline SortThresholdStore& sortThresholdStore() {
+  static SortThresholdStore store{SortThresholds{}.radixMinSize, SortThresholds{}.parallelMinSize,
+                                  SortThresholds{}.presortedFraction,
+                                  SortThresholds{}.duplicateFraction};
+  return store;
+}
+
+// Whether clavis::sort may hand [It, It) to the LSD radix sorts.
+template <typename It, typename Compare, typename Proj>
+constexpr bool sortDispatchRadixApplies() {
+  using T = std::iter_value_t<It>;
+  if constexpr (std::contiguous_iterator<It> && RadixSortable<T> &&
+                std::same_as<Proj, std::identity>) {
+    using Reference = std::remove_reference_t<std::iter_reference_t<It>>;
+    return NaturalOrder<Compare, T> && !std::is_const_v<Reference>;
+  } else {
+    return false;
+  }
+}
+
+// Best of three timings of sort applied to consecutive size-element slices
+// of a copy of input.
+template <typename Sort>
+double sortCalibrationSeconds(const std::vector<std::uint32_t>& input, std::size_t size,
+                              Sort sort) {
+  std::vector<std::uint32_t> work(input.size());
+  double best = std::numeric_limits<double>::infinity();
+  for (int rep = 0; rep < 3; ++rep) {
+    std::ranges::copy(input, work.begin());
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t offset = 0; offset + size <= work.size(); offset += size) {
+      sort(std::span<std::uint32_t>(work.data() + offset, size));
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    best = std::min(best, elapsed.count());
+  }
+  return best;
+}
+
+// Smallest size in [from, to] (doubling) from which candidate beats baseline
+// at that size and the next, or max() if it never does.
+template <typename Candidate, typename Baseline>
+std::ptrdiff_t sortCalibrationCrossover(const std::vector<std::uint32_t>& input,
+                                        std::size_t from, std::size_t to, Candidate candidate,
+                                        Baseline baseline) {
+  std::size_t winsFrom = 0;
+  for (std::size_t size = from; size <= to; size *= 2) {
+    bool wins = sortCalibrationSeconds(input, size, candidate) <
+                sortCalibrationSeconds(input, size, baseline);
+    if (!wins) {
+      winsFrom = 0;
+    } else if (winsFrom == 0) {
+      winsFrom = size;
+    } else {
+      return static_cast<std::ptrdiff_t>(winsFrom);
+    }
+  }
+  // A win at the largest size measured is enough.
+  return winsFrom != 0 ? static_cast<std::ptrdiff_t>(winsFrom)
+                       : std::numeric_limits<std::ptrdiff_t>::max();
+}
+
+}  // namespace detail
+
+/**
+ * @brief The thresholds clavis::sort currently decides by
+ */
+inline SortThresholds sortThresholds() {
+  auto& store = detail::sortThresholdStore();
+  return {store.radixMinSize.load(std::memory_order_relaxed),
+          store.parallelMinSize.load(std::memory_order_relaxed),
+          store.presortedFraction.load(std::memory_order_relaxed),
+          store.duplicateFraction.load(std::memory_order_relaxed)};
+}
+
+/**
+ * @brief Makes clavis::sort decide by thresholds from now on
+ * @throws std::invalid_argument if a size is not positive or a fraction lies
+ *         outside [0, 1]
+ */
+inline void setSortThresholds(const SortThresholds& thresholds) {
+  if (thresholds.radixMinSize <= 0 || thresholds.parallelMinSize <= 0) {
+    throw std::invalid_argument("Sort threshold sizes must be positive");
+  }
+  if (!(thresholds.presortedFraction >= 0 && thresholds.presortedFraction <= 1) ||
+      !(thresholds.duplicateFraction >= 0 && thresholds.duplicateFraction <= 1)) {
+    throw std::invalid_argument("Sort threshold fractions must lie in [0, 1]");
+  }
+  auto& store = detail::sortThresholdStore();
+  store.radixMinSize.store(thresholds.radixMinSize, std::memory_order_relaxed);
+  store.parallelMinSize.store(thresholds.parallelMinSize, std::memory_order_relaxed);
+  store.presortedFraction.store(thresholds.presortedFraction, std::memory_order_relaxed);
+  store.duplicateFraction.store(thresholds.duplicateFraction, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Measures the size thresholds on this machine
+ *
+ * Times pdqsort against radix sort on random 32-bit keys from 64 to 64Ki
+ * elements, and pdqsort against the parallel sample sort from 32Ki to 512Ki
+ * elements when more than one hardware thread is available. Takes on the
+ * order of a second; run it once and keep the result with
+ * writeSortThresholds, or use loadOrCalibrateSortThresholds.
+ */
+inline SortThresholds calibrateSortThresholds() {
+  std::mt19937 gen(1);
+  std::vector<std::uint32_t> input(kSortCalibrationElements);
+  for (auto& x : input) x = static_cast<std::uint32_t>(gen());
+
+  auto pdq = [](std::span<std::uint32_t> slice) { pdqSort(slice); };
+  SortThresholds thresholds;
+  thresholds.radixMinSize = detail::sortCalibrationCrossover(
+      input, 64, std::size_t{1} << 16, [](std::span<std::uint32_t> slice) { radixSort(slice); },
+      pdq);
+
+  std::size_t threads = resolveThreadCount(0);
+  if (threads == 1) {
+    thresholds.parallelMinSize = std::numeric_limits<std::ptrdiff_t>::max();
+  } else {
+    input.resize(std::size_t{1} << 19);
+    for (auto& x : input) x = static_cast<std::uint32_t>(gen());
+    thresholds.parallelMinSize = detail::sortCalibrationCrossover(
+        input, std::size_t{1} << 15, input.size(),
+        [threads](std::span<std::uint32_t> slice) {
+          parallelSampleSort(slice, std::ranges::less{}, std::identity{}, threads);
+        },
+        pdq);
+  }
+  return thresholds;
+}
+
+/**
+ * @brief Writes thresholds as "name value" lines that readSortThresholds
+ *        accepts
+ */
+inline void writeSortThresholds(std::ostream& out, const SortThresholds& thresholds) {
+  out.precision(std::numeric_limits<double>::max_digits10);
+  out << "radixMinSize " << thresholds.radixMinSize << '\n'
+      << "parallelMinSize " << thresholds.parallelMinSize << '\n'
+      << "presortedFraction " << thresholds.presortedFraction << '\n'
+      << "duplicateFraction " << thresholds.duplicateFraction << '\n';
+}
+
+/**
+ * @brief Reads thresholds written by writeSortThresholds
+ *
+ * Names missing from the input keep their defaults.
+ *
+ * @throws std::invalid_argument on an unknown name or a malformed value
+ */
+inline SortThresholds readSortThresholds(std::istream& in) {
+  SortThresholds thresholds;
+  std::string name;
+  while (in >> name) {
+    bool ok;
+    if (name == "radixMinSize") {
+      ok = static_cast<bool>(in >> thresholds.radixMinSize);
+    } else if (name == "parallelMinSize") {
+      ok = static_cast<bool>(in >> thresholds.parallelMinSize);
+    } else if (name == "presortedFraction") {
+      ok = static_cast<bool>(in >> thresholds.presortedFraction);
+    } else if (name == "duplicateFraction") {
+      ok = static_cast<bool>(in >> thresholds.duplicateFraction);
+    } else {
+      throw std::invalid_argument("Unknown sort threshold " + name);
+    }
+    if (!ok) {
+      throw std::invalid_argument("Malformed value for sort threshold " + name);
+    }
+  }
+  return thresholds;
+}
+
+/**
+ * @brief Installs the thresholds cached at path, calibrating and writing
+ *        them there first if the file does not exist
+ *
+ * @return The thresholds now in effect
+ * @throws std::invalid_argument if the cached file is malformed
+ * @throws std::runtime_error if a new cache file cannot be written
+ */
+inline SortThresholds loadOrCalibrateSortThresholds(const std::filesystem::path& path) {
+  SortThresholds thresholds;
+  if (std::ifstream in(path); in) {
+    thresholds = readSortThresholds(in);
+  } else {
+    thresholds = calibrateSortThresholds();
+    std::ofstream out(path);
+    writeSortThresholds(out, thresholds);
+    if (!out.flush()) {
+      throw std::runtime_error("Cannot write sort thresholds to " + path.string());
+    }
+  }
+  setSortThresholds(thresholds);
+  return thresholds;
+}
+
+/**
+ * @brief Sorts [first, last) by comp applied to proj of each element with
+ *        whichever of the library's sorts suits the input best
+ *
+ * Tiny ranges go to smallSort (sorting networks where the keys allow it).
+ * Larger ones are probed with probeSortInput: presorted or reverse-sorted
+ * input goes to powersort, which merges its natural runs. Natural-order
+ * arithmetic keys go to LSD radix sort from the calibrated size on, unless
+ * the sample is duplicate-heavy, where pdqsort's equal-key partitioning
+ * wins. Everything else goes to pdqsort, or to powersort when a stable sort
+ * is required. With opts.threads != 1, inputs above the parallel threshold
+ * use the parallel radix, merge or sample sort instead.
+ *
+ * @return The algorithm that sorted the range
+ */
+template <std::random_access_iterator It, typename Compare = std::ranges::less,
+          typename Proj = std::identity>
+  requires SortableIterator<It, Compare, Proj> && std::movable<std::iter_value_t<It>>
+SortAlgorithm sort(It first, It last, SortOptions opts = {}, Compare comp = {}, Proj proj = {}) {
+  using T = std::iter_value_t<It>;
+  auto n = last - first;
+  auto projected = projectedComparator(comp, proj);
+  if (n <= kSortingNetworkMaxSize) {
+    if (opts.stable && !std::integral<T>) {
+      insertionSortImpl(first, last, projected);
+    } else {
+      smallSort(first, last, projected);
+    }
+    return SortAlgorithm::kSmallSort;
+  }
+
+  SortThresholds thresholds = sortThresholds();
+  bool radix = false;
+  if constexpr (detail::sortDispatchRadixApplies<It, Compare, Proj>()) {
+    // Radix sort orders -0.0 before 0.0 whatever their input order. The size
+    // is scaled rather than the threshold, which calibration may set to max().
+    radix = (!opts.stable || std::integral<T>) &&
+            static_cast<double>(n) * 4 / sizeof(T) >= static_cast<double>(thresholds.radixMinSize);
+  }
+  if (n >= kSortProbeMinSize) {
+    SortProbe probe = probeSortInput(first, last, projected);
+    if (probe.ascending >= thresholds.presortedFraction ||
+        probe.descending >= thresholds.presortedFraction) {
+      powerSort(first, last, comp, proj);
+      return SortAlgorithm::kPowerSort;
+    }
+    if (!opts.stable && probe.duplicates >= thresholds.duplicateFraction) {
+      pdqSort(first, last, comp, proj);
+      return SortAlgorithm::kPdqSort;
+    }
+  }
+
+  if (opts.threads != 1 && n >= thresholds.parallelMinSize) {
+    if constexpr (detail::sortDispatchRadixApplies<It, Compare, Proj>()) {
+      if (radix) {
+        parallelRadixSort(std::span<T>(std::to_address(first), static_cast<std::size_t>(n)),
+                          opts.threads);
+        return SortAlgorithm::kParallelRadixSort;
+      }
+    }
+    if (!opts.stable) {
+      parallelSampleSort(first, last, projected, opts.threads);
+      return SortAlgorithm::kParallelSampleSort;
+    }
+    if constexpr (std::copyable<T>) {
+      parallelMergeSort(std::ranges::subrange(first, last), comp, proj, opts.threads);
+      return SortAlgorithm::kParallelMergeSort;
+    }
+  }
+  if constexpr (detail::sortDispatchRadixApplies<It, Compare, Proj>()) {
+    if (radix) {
+      radixSort(std::span<T>(std::to_address(first), static_cast<std::size_t>(n)));
+      return SortAlgorithm::kRadixSort;
+    }
+  }
+  if (opts.stable) {
+    powerSort(first, last, comp, proj);
+    return SortAlgorithm::kPowerSort;
+  }
+  pdqSort(first, last, comp, proj);
+  return SortAlgorithm::kPdqSort;
+}
+
+template <std::ranges::random_access_range R, typename Compare = std::ranges::less,
+          typename Proj = std::identity>
+  requires SortableRange<R, Compare, Proj> && std::movable<std::ranges::range_value_t<R>>
+SortAlgorithm sort(R&& range, SortOptions opts = {}, Compare comp = {}, Proj proj = {}) {
+  auto first = std::ranges::begin(range);
+  return clavis::sort(first, std::ranges::next(first, std::ranges::end(range)), opts, comp, proj);
+}
+
+}  // namespace clavis
+
+#endif  // SORT_DISPATCH_HPP
@@ -0,0 +1,102 @@
+#ifndef SORT_OBSERVER_HPP
+#define SORT_OBSERVER_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <ostream>
+
+/**
+ * @brief Policy notified by the sorts about the work they do
+ *
+ * Observers are passed by value and their hooks are const, so they are meant
+ * to be cheap handles: an empty policy, or one that points at external state.
+ */
+template <typename O>
+concept SortObserver = std::copy_constructible<O> && requires(const O observer, std::size_t n) {
+  observer.onCompare();    // One comparison of two elements
+  observer.onSwap();       // One exchange of two elements
+  observer.onMove(n);      // n elements moved or copied
+  observer.onRecurse(n);   // Entered recursion depth or pass n
+  observer.onAllocate(n);  // n bytes of scratch allocated
+};
+
+/**
+ * @brief Default policy: every hook is empty and inlines away
+ */
+struct NullSortObserver {
+  constexpr void onCompare() const noexcept {}
+  constexpr void onSwap() const noexcept {}
+  constexpr void onMove(std::size_t /*count*/) const noexcept {}
+  constexpr void onRecurse(std::size_t /*depth*/) const noexcept {}
+  constexpr void onAllocate(std::size_t /*bytes*/) const noexcept {}
+};
+
+/**
+ * @brief Totals collected by CountingSortObserver
+ */
+struct SortStats {
+  std::uint64_t comparisons = 0;
+  std::uint64_t swaps = 0;
+  std::uint64_t moves = 0;
+  std::uint64_t allocatedBytes = 0;
+  std::size_t maxDepth = 0;
+};
+
+/**
+ * @brief Policy that accumulates operation counts into a SortStats
+ *
+ * Not synchronized; use one SortStats per sorting thread.
+ */
+class CountingSortObserver {
+ public:
+  explicit CountingSortObserver(SortStats& stats) : stats_(&stats) {}
+
+  void onCompare() const { ++stats_->comparisons; }
+  void onSwap() const { ++stats_->swaps; }
+  void onMove(std::size_t count) const { stats_->moves += count; }
+  void onRecurse(std::size_t depth) const { stats_->maxDepth = std::max(stats_->maxDepth, depth); }
+  void onAllocate(std::size_t bytes) const { stats_->allocatedBytes += bytes; }
+
+ private:
+  SortStats* stats_;
+};
+
+/**
+ * @brief Policy that writes one line per event, for debugging small inputs
+ */
+class TracingSortObserver {
+ public:
+  explicit TracingSortObserver(std::ostream& out = std::clog) : out_(&out) {}
+
+  void onCompare() const { *out_ << "compare\n"; }
+  void onSwap() const { *out_ << "swap\n"; }
+  void onMove(std::size_t count) const { *out_ << "move " << count << '\n'; }
+  void onRecurse(std::size_t depth) const { *out_ << "depth " << depth << '\n'; }
+  void onAllocate(std::size_t bytes) const { *out_ << "allocate " << bytes << " bytes\n"; }
+
+ private:
+  std::ostream* out_;
+};
+
+/**
+ * @brief Wraps comp so every call is reported to observer
+ *
+ * Returns comp unchanged for NullSortObserver, which keeps the comparator type
+ * recognizable to the vectorized fast paths.
+ */
+template <typename Compare, SortObserver Observer>
+auto observeComparisons(Compare comp, Observer observer) {
+  if constexpr (std::same_as<Observer, NullSortObserver>) {
+    return comp;
+  } else {
+    return [comp, observer](const auto& a, const auto& b) {
+      observer.onCompare();
+      return comp(a, b);
+    };
+  }
+}
+
+#endif  // SORT_OBSERVER_HPP
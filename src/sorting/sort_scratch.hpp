@@ -0,0 +1,66 @@
+#ifndef SORT_SCRATCH_HPP
+#define SORT_SCRATCH_HPP
+
+#include <cstddef>
+#include <memory_resource>
+
+// Size of the per-thread arena that small sorts take their scratch space from.
+inline constexpr std::size_t kSortScratchArenaBytes = std::size_t{1} << 16;
+
+/**
+ * @brief Picks the memory resource one sort allocates its scratch space from
+ *
+ * A caller-provided resource is used as is. Otherwise requests of up to
+ * kSortScratchArenaBytes come from a thread-local monotonic arena, which
+ * takes a pointer bump per allocation and never touches the global heap or
+ * its locks, and larger ones from std::pmr::get_default_resource(). The
+ * arena is rewound when the outermost lease on the thread ends, so sorts
+ * nested inside a comparator or projection share it safely and overflow to
+ * the heap only while nested.
+ *
+ * Scratch allocated through resource() must be freed before the lease ends.
+ */
+class SortScratchLease {
+ public:
+  explicit SortScratchLease(std::size_t bytes, std::pmr::memory_resource* resource = nullptr) {
+    if (resource != nullptr) {
+      resource_ = resource;
+    } else if (bytes <= kSortScratchArenaBytes) {
+      Arena& arena = threadArena();
+      ++arena.leases;
+      resource_ = &arena.resource;
+      leased_ = &arena;
+    } else {
+      resource_ = std::pmr::get_default_resource();
+    }
+  }
+
+  ~SortScratchLease() {
+    if (leased_ != nullptr && --leased_->leases == 0) {
+      leased_->resource.release();
+    }
+  }
+
+  SortScratchLease(const SortScratchLease&) = delete;
+  SortScratchLease& operator=(const SortScratchLease&) = delete;
+
+  std::pmr::memory_resource* resource() const { return resource_; }
+
+ private:
+  struct Arena {
+    alignas(std::max_align_t) std::byte storage[kSortScratchArenaBytes];
+    std::pmr::monotonic_buffer_resource resource{storage, sizeof(storage),
+                                                 std::pmr::new_delete_resource()};
+    int leases = 0;
+  };
+
+  static Arena& threadArena() {
+    thread_local Arena arena;
+    return arena;
+  }
+
+  std::pmr::memory_resource* resource_;
+  Arena* leased_ = nullptr;
+};
+
+#endif  // SORT_SCRATCH_HPP
@@ -0,0 +1,432 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "bubble_sort.hpp"
+#include "heap_sort.hpp"
+#include "insertion_sort.hpp"
+#include "merge_sort.hpp"
+#include "pdq_sort.hpp"
+#include "power_sort.hpp"
+#include "quick_sort.hpp"
+#include "radix_sort.hpp"
+#include "sample_sort.hpp"
+#include "shell_sort.hpp"
+#include "sort_dispatch.hpp"
+#include "string_sort.hpp"
+
+namespace {
+
+// Quadratic sorts are only run up to this many elements.
+constexpr std::size_t kBenchQuadraticMaxSize = std::size_t{1} << 12;
+// Keys of the non-uniform distributions stay below this, so every element
+// type can represent them in order.
+constexpr std::uint64_t kBenchKeyUniverse = std::uint64_t{1} << 31;
+// Distinct keys in the few-unique distribution.
+constexpr std::uint64_t kBenchFewUniqueKeys = 16;
+// Distinct ranks the Zipf distribution draws from at most.
+constexpr std::size_t kBenchZipfRanks = std::size_t{1} << 20;
+
+struct BenchOptions {
+  std::size_t minSize = 16;
+  std::size_t maxSize = std::size_t{1} << 20;
+  std::size_t minReps = 3;
+  std::size_t maxReps = 1000;
+  // Repetitions continue until their sorts add up to this long.
+  double minSeconds = 0.05;
+  std::size_t threads = 0;
+  std::vector<std::string> types;
+  std::vector<std::string> distributions;
+  std::string algorithmFilter;
+  std::string output;
+};
+
+// 32-byte record sorted by its first field.
+struct Record32 {
+  std::uint64_t key;
+  std::uint64_t payload[3];
+};
+
+template <typename T>
+struct BenchType;
+
+template <>
+struct BenchType<std::int32_t> {
+  static constexpr std::string_view kName = "int32";
+  static std::int32_t fromKey(std::uint64_t key) {
+    return static_cast<std::int32_t>(static_cast<std::int64_t>(key % kBenchKeyUniverse) -
+                                     (std::int64_t{1} << 30));
+  }
+  static constexpr std::identity kProj{};
+};
+
+template <>
+struct BenchType<std::uint64_t> {
+  static constexpr std::string_view kName = "uint64";
+  static std::uint64_t fromKey(std::uint64_t key) {
+    // The low half varies so equal-looking prefixes do not hide radix digits.
+    return (key << 32) | ((key * 0x9E3779B97F4A7C15ULL) >> 32);
+  }
+  static constexpr std::identity kProj{};
+};
+
+template <>
+struct BenchType<double> {
+  static constexpr std::string_view kName = "double";
+  static double fromKey(std::uint64_t key) { return static_cast<double>(key) * 1e-3 - 1e6; }
+  static constexpr std::identity kProj{};
+};
+
+template <>
+struct BenchType<std::string> {
+  static constexpr std::string_view kName = "string";
+  static std::string fromKey(std::uint64_t key) {
+    std::string digits = std::to_string(key % kBenchKeyUniverse);
+    return "key-" + std::string(10 - digits.size(), '0') + digits;
+  }
+  static constexpr std::identity kProj{};
+};
+
+template <>
+struct BenchType<Record32> {
+  static constexpr std::string_view kName = "record32";
+  static Record32 fromKey(std::uint64_t key) {
+    return {BenchType<std::uint64_t>::fromKey(key), {key, key, key}};
+  }
+  static constexpr auto kProj = &Record32::key;
+};
+
+// Bytes an element occupies, counting string characters rather than the
+// string object.
+template <typename T>
+std::size_t benchBytes(const std::vector<T>& values) {
+  if constexpr (std::same_as<T, std::string>) {
+    std::size_t bytes = 0;
+    for (const auto& value : values) bytes += value.size();
+    return bytes;
+  } else {
+    return values.size() * sizeof(T);
+  }
+}
+
+const std::vector<std::string>& benchDistributions() {
+  static const std::vector<std::string> names = {
+      "uniform", "sorted", "reversed", "organ-pipe", "few-unique", "zipf", "nearly-sorted"};
+  return names;
+}
+
+const std::vector<std::string>& benchTypes() {
+  static const std::vector<std::string> names = {"int32", "uint64", "double", "string",
+                                                 "record32"};
+  return names;
+}
+
+/**
+ * @brief Keys of n elements drawn from the named distribution
+ * @throws std::invalid_argument for an unknown distribution
+ */
+std::vector<std::uint64_t> benchKeys(const std::string& distribution, std::size_t n,
+                                     std::mt19937_64& gen) {
+  std::vector<std::uint64_t> keys(n);
+  if (distribution == "uniform") {
+    for (auto& key : keys) key = gen() % kBenchKeyUniverse;
+  } else if (distribution == "sorted" || distribution == "nearly-sorted") {
+    std::iota(keys.begin(), keys.end(), std::uint64_t{0});
+    if (distribution == "nearly-sorted") {
+      // One percent of the elements swapped with random partners.
+      for (std::size_t i = 0; i < n / 100; ++i) std::swap(keys[gen() % n], keys[gen() % n]);
+    }
+  } else if (distribution == "reversed") {
+    for (std::size_t i = 0; i < n; ++i) keys[i] = n - i;
+  } else if (distribution == "organ-pipe") {
+    for (std::size_t i = 0; i < n; ++i) keys[i] = std::min(i, n - i);
+  } else if (distribution == "few-unique") {
+    for (auto& key : keys) key = gen() % kBenchFewUniqueKeys;
+  } else if (distribution == "zipf") {
+    // Inverse-CDF sampling of ranks with P(rank r) proportional to 1 / (r + 1).
+    std::vector<double> cdf(std::clamp<std::size_t>(n, 1, kBenchZipfRanks));
+    double total = 0;
+    for (std::size_t r = 0; r < cdf.size(); ++r) {
+      total += 1.0 / static_cast<double>(r + 1);
+      cdf[r] = total;
+    }
+    std::uniform_real_distribution<double> uniform(0, total);
+    for (auto& key : keys) {
+      key = static_cast<std::uint64_t>(std::ranges::lower_bound(cdf, uniform(gen)) - cdf.begin());
+    }
+  } else {
+    throw std::invalid_argument("Unknown distribution " + distribution);
+  }
+  return keys;
+}
+
+template <typename T>
+struct BenchAlgorithm {
+  std::string name;
+  std::size_t maxSize;
+  std::function<void(std::vector<T>&)> sort;
+};
+
+/**
+ * @brief Every sort in src/sorting that accepts elements of type T
+ */
+template <typename T>
+std::vector<BenchAlgorithm<T>> benchAlgorithms(std::size_t threads) {
+  // Type::kProj is a static member, so the lambdas need not capture it.
+  using Type = BenchType<T>;
+  constexpr std::size_t unlimited = std::numeric_limits<std::size_t>::max();
+  std::vector<BenchAlgorithm<T>> algorithms = {
+      {"std::sort", unlimited, [](auto& v) { std::ranges::sort(v, {}, Type::kProj); }},
+      {"std::stable_sort", unlimited,
+       [](auto& v) { std::ranges::stable_sort(v, {}, Type::kProj); }},
+      {"bubbleSort", kBenchQuadraticMaxSize, [](auto& v) { bubbleSort(v, {}, Type::kProj); }},
+      {"insertionSort", kBenchQuadraticMaxSize, [](auto& v) { insertionSort(v, {}, Type::kProj); }},
+      {"shellSort", unlimited, [](auto& v) { shellSort(v, {}, Type::kProj); }},
+      {"heapSort", unlimited, [](auto& v) { heapSort(v, {}, Type::kProj); }},
+      {"quickSort", unlimited, [](auto& v) { quickSort(v, {}, Type::kProj); }},
+      {"pdqSort", unlimited, [](auto& v) { pdqSort(v, {}, Type::kProj); }},
+      {"mergeSort", unlimited, [](auto& v) { mergeSort(v, {}, Type::kProj); }},
+      {"powerSort", unlimited, [](auto& v) { powerSort(v, {}, Type::kProj); }},
+      {"sampleSort", unlimited, [](auto& v) { sampleSort(v, {}, Type::kProj); }},
+      {"clavis::sort", unlimited, [](auto& v) { clavis::sort(v, {}, {}, Type::kProj); }},
+      {"clavis::sort/parallel", unlimited,
+       [threads](auto& v) { clavis::sort(v, {.threads = threads}, {}, Type::kProj); }},
+      {"parallelSampleSort", unlimited,
+       [threads](auto& v) { parallelSampleSort(v, {}, Type::kProj, threads); }},
+      {"parallelMergeSort", unlimited,
+       [threads](auto& v) { parallelMergeSort(v, {}, Type::kProj, threads); }},
+  };
+  if constexpr (RadixSortable<T>) {
+    algorithms.push_back({"radixSort", unlimited, [](auto& v) { radixSort(v); }});
+    algorithms.push_back({"americanFlagSort", unlimited, [](auto& v) { americanFlagSort(v); }});
+    algorithms.push_back({"parallelRadixSort", unlimited,
+                          [threads](auto& v) { parallelRadixSort(v, threads); }});
+    algorithms.push_back({"parallelAmericanFlagSort", unlimited,
+                          [threads](auto& v) { parallelAmericanFlagSort(v, threads); }});
+  } else if constexpr (std::same_as<T, Record32>) {
+    algorithms.push_back(
+        {"radixSortBy", unlimited, [](auto& v) { radixSortBy(v, &Record32::key); }});
+    algorithms.push_back({"americanFlagSortBy", unlimited, [](auto& v) {
+                            americanFlagSortBy(std::span<Record32>{v}, &Record32::key);
+                          }});
+  } else if constexpr (std::same_as<T, std::string>) {
+    algorithms.push_back({"multikeyQuickSort", unlimited, [](auto& v) { multikeyQuickSort(v); }});
+    algorithms.push_back({"msdStringSort", unlimited, [](auto& v) { msdStringSort(v); }});
+    algorithms.push_back({"lcpMergeSort", unlimited, [](auto& v) { lcpMergeSort(v); }});
+  }
+  return algorithms;
+}
+
+std::string jsonEscape(std::string_view text) {
+  std::string escaped;
+  for (char c : text) {
+    if (c == '"' || c == '\\') escaped += '\\';
+    escaped += c;
+  }
+  return escaped;
+}
+
+/**
+ * @brief Writes one JSON result object per algorithm run on each size and
+ *        distribution for element type T
+ */
+template <typename T>
+void runBenchType(const BenchOptions& options, std::ostream& out, bool& firstResult) {
+  std::mt19937_64 gen(42);
+  auto algorithms = benchAlgorithms<T>(options.threads);
+  for (const auto& distribution : options.distributions) {
+    for (std::size_t n = options.minSize; n <= options.maxSize;
+         n = n > options.maxSize / 4 && n != options.maxSize ? options.maxSize : n * 4) {
+      std::vector<T> input;
+      input.reserve(n);
+      for (std::uint64_t key : benchKeys(distribution, n, gen)) {
+        input.push_back(BenchType<T>::fromKey(key));
+      }
+      std::size_t bytes = benchBytes(input);
+      for (const auto& algorithm : algorithms) {
+        if (n > algorithm.maxSize ||
+            algorithm.name.find(options.algorithmFilter) == std::string::npos) {
+          continue;
+        }
+        std::vector<double> seconds;
+        double total = 0;
+        std::vector<T> work;
+        bool sorted = true;
+        while (seconds.size() < options.maxReps &&
+               (seconds.size() < options.minReps || total < options.minSeconds)) {
+          work = input;
+          auto start = std::chrono::steady_clock::now();
+          algorithm.sort(work);
+          std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+          seconds.push_back(elapsed.count());
+          total += elapsed.count();
+          if (seconds.size() == 1) {
+            sorted = std::ranges::is_sorted(work, {}, BenchType<T>::kProj);
+          }
+        }
+        std::ranges::sort(seconds);
+        double best = std::max(seconds.front(), 1e-9);
+        double median = seconds[seconds.size() / 2];
+        out << (firstResult ? "\n" : ",\n") << "    {\"algorithm\": \""
+            << jsonEscape(algorithm.name) << "\", \"type\": \"" << BenchType<T>::kName
+            << "\", \"distribution\": \"" << distribution << "\", \"size\": " << n
+            << ", \"reps\": " << seconds.size()
+            << ", \"ns_per_element\": " << best * 1e9 / static_cast<double>(n)
+            << ", \"median_ns_per_element\": " << median * 1e9 / static_cast<double>(n)
+            << ", \"gb_per_second\": " << static_cast<double>(bytes) / best / 1e9
+            << ", \"sorted\": " << (sorted ? "true" : "false") << "}";
+        out.flush();
+        firstResult = false;
+      }
+    }
+  }
+}
+
+std::vector<std::string> splitList(std::string_view list) {
+  std::vector<std::string> items;
+  for (auto item : std::views::split(list, ',')) items.emplace_back(item.begin(), item.end());
+  return items;
+}
+
+void printUsage(std::ostream& out) {
+  out << "Usage: clavis_sorting_bench [options]\n"
+         "  --min-size=N        smallest input size (default 16)\n"
+         "  --max-size=N        largest input size, up to 1000000000 (default 1048576);\n"
+         "                      sizes grow by 4x from the smallest\n"
+         "  --types=a,b         int32,uint64,double,string,record32 (default all)\n"
+         "  --distributions=a,b uniform,sorted,reversed,organ-pipe,few-unique,zipf,\n"
+         "                      nearly-sorted (default all)\n"
+         "  --algorithms=TEXT   only algorithms whose name contains TEXT\n"
+         "  --min-reps=N        repetitions per measurement at least (default 3)\n"
+         "  --min-seconds=S     repeat until the sorts took this long (default 0.05)\n"
+         "  --threads=N         threads for the parallel sorts (default: all cores)\n"
+         "  --output=PATH       write the JSON report to PATH instead of stdout\n";
+}
+
+/**
+ * @brief Parses --name=value options
+ * @throws std::invalid_argument on unknown options or malformed values
+ */
+BenchOptions parseOptions(int argc, char** argv) {
+  BenchOptions options;
+  options.types = benchTypes();
+  options.distributions = benchDistributions();
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    auto equals = arg.find('=');
+    std::string name(arg.substr(0, equals));
+    std::string value(equals == std::string_view::npos ? "" : arg.substr(equals + 1));
+    auto number = [&] {
+      std::size_t parsed = 0;
+      unsigned long long result = std::stoull(value, &parsed);
+      if (parsed != value.size()) throw std::invalid_argument("Malformed value for " + name);
+      return static_cast<std::size_t>(result);
+    };
+    if (name == "--min-size") {
+      options.minSize = number();
+    } else if (name == "--max-size") {
+      options.maxSize = number();
+    } else if (name == "--types") {
+      options.types = splitList(value);
+    } else if (name == "--distributions") {
+      options.distributions = splitList(value);
+    } else if (name == "--algorithms") {
+      options.algorithmFilter = value;
+    } else if (name == "--min-reps") {
+      options.minReps = std::max<std::size_t>(number(), 1);
+    } else if (name == "--min-seconds") {
+      options.minSeconds = std::stod(value);
+    } else if (name == "--threads") {
+      options.threads = number();
+    } else if (name == "--output") {
+      options.output = value;
+    } else {
+      throw std::invalid_argument("Unknown option " + std::string(arg));
+    }
+  }
+  if (options.minSize == 0 || options.minSize > options.maxSize) {
+    throw std::invalid_argument("Sizes must satisfy 0 < min-size <= max-size");
+  }
+  for (const auto& type : options.types) {
+    if (std::ranges::find(benchTypes(), type) == benchTypes().end()) {
+      throw std::invalid_argument("Unknown type " + type);
+    }
+  }
+  for (const auto& distribution : options.distributions) {
+    if (std::ranges::find(benchDistributions(), distribution) == benchDistributions().end()) {
+      throw std::invalid_argument("Unknown distribution " + distribution);
+    }
+  }
+  return options;
+}
+
+// Unoptimized builds time the debug code paths, not the algorithms.
+#if defined(__OPTIMIZE__) || (defined(_MSC_VER) && defined(NDEBUG))
+constexpr bool kBenchOptimized = true;
+#else
+constexpr bool kBenchOptimized = false;
+#endif
+
+std::string currentTime() {
+  std::time_t now = std::time(nullptr);
+  char buffer[32];
+  std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+  return buffer;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  try {
+    for (int i = 1; i < argc; ++i) {
+      if (std::string_view(argv[i]) == "--help") {
+        printUsage(std::cout);
+        return 0;
+      }
+    }
+    BenchOptions options = parseOptions(argc, argv);
+    std::ofstream file;
+    if (!options.output.empty()) {
+      file.open(options.output);
+      if (!file) throw std::runtime_error("Cannot create " + options.output);
+    }
+    std::ostream& out = options.output.empty() ? std::cout : file;
+
+    out << "{\n  \"context\": {\"date\": \"" << currentTime() << "\", \"compiler\": \""
+        << jsonEscape(__VERSION__) << "\", \"hardware_threads\": "
+        << std::thread::hardware_concurrency()
+        << ", \"bench_threads\": " << resolveThreadCount(options.threads)
+        << ", \"optimized\": " << (kBenchOptimized ? "true" : "false") << "},\n"
+        << "  \"results\": [";
+    bool firstResult = true;
+    for (const auto& type : options.types) {
+      if (type == "int32") runBenchType<std::int32_t>(options, out, firstResult);
+      if (type == "uint64") runBenchType<std::uint64_t>(options, out, firstResult);
+      if (type == "double") runBenchType<double>(options, out, firstResult);
+      if (type == "string") runBenchType<std::string>(options, out, firstResult);
+      if (type == "record32") runBenchType<Record32>(options, out, firstResult);
+    }
+    out << "\n  ]\n}\n";
+    return 0;
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << '\n';
+    printUsage(std::cerr);
+    return 1;
+  }
+}
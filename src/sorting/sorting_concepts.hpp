@@ -2,21 +2,60 @@
 #define SORTING_CONCEPTS_HPP
 
 #include <concepts>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <ranges>
 
-// clang-format off
-template <typename T>
-concept Sortable = requires(T a, T b) {
-  { a < b } -> std::convertible_to<bool>;
-};
-// clang-format on
+// A value type ordered by Compare; the default only needs operator<.
+template <typename T, typename Compare = std::less<>>
+concept Sortable = std::strict_weak_order<Compare, const T&, const T&>;
 
-template <typename T>
-concept Pivotable = Sortable<T> && std::movable<T>;
+template <typename T, typename Compare = std::less<>>
+concept Pivotable = Sortable<T, Compare> && std::movable<T>;
 
-template <typename T>
-concept Mergeable = Sortable<T> && std::copyable<T>;
+template <typename T, typename Compare = std::less<>>
+concept Mergeable = Sortable<T, Compare> && std::copyable<T>;
+
+template <typename T, typename Compare = std::less<>>
+concept Heapable = Sortable<T, Compare> && std::swappable<T>;
+
+// Iterators whose elements can be reordered in place by Compare applied to
+// the projected values, as for std::ranges::sort.
+template <typename It, typename Compare = std::ranges::less, typename Proj = std::identity>
+concept SortableIterator = std::random_access_iterator<It> && std::sortable<It, Compare, Proj>;
+
+template <typename R, typename Compare = std::ranges::less, typename Proj = std::identity>
+concept SortableRange = std::ranges::random_access_range<R> &&
+                        SortableIterator<std::ranges::iterator_t<R>, Compare, Proj>;
+
+// Mergeable ranges additionally need their elements copied into scratch space.
+template <typename R, typename Compare = std::ranges::less, typename Proj = std::identity>
+concept MergeableRange =
+    SortableRange<R, Compare, Proj> && std::copyable<std::ranges::range_value_t<R>>;
+
+/**
+ * @brief Folds a projection into a comparator
+ *
+ * Returns comp unchanged for std::identity, so the sorts can still recognize
+ * the natural orders they have vectorized paths for.
+ */
+template <typename Compare, typename Proj>
+auto projectedComparator(Compare comp, Proj proj) {
+  if constexpr (std::same_as<Proj, std::identity>) {
+    return comp;
+  } else {
+    return [comp, proj](const auto& a, const auto& b) {
+      return std::invoke(comp, std::invoke(proj, a), std::invoke(proj, b));
+    };
+  }
+}
 
+// Arithmetic types whose ordering radix sort can reproduce through an
+// order-preserving unsigned key: integers (except bool) and IEEE-754 float/double.
 template <typename T>
-concept Heapable = Sortable<T> && std::swappable<T>;
+concept RadixSortable = (std::integral<T> && !std::same_as<T, bool>) ||
+                        (std::floating_point<T> && std::numeric_limits<T>::is_iec559 &&
+                         (sizeof(T) == 4 || sizeof(T) == 8));
 
 #endif  // 　SORTING_CONCEPTS_HPP
\ No newline at end of file
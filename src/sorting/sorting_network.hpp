@@ -0,0 +1,340 @@
+#ifndef SORTING_NETWORK_HPP
+#define SORTING_NETWORK_HPP
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+
+#include "insertion_sort.hpp"
+#include "sort_observer.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define CLAVIS_HAS_AVX2_KERNELS 1
+#define CLAVIS_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define CLAVIS_HAS_AVX2_KERNELS 0
+#endif
+
+// Largest range sorted in registers by sortingNetworkSort.
+inline constexpr std::ptrdiff_t kSortingNetworkMaxSize = 64;
+
+// Element types with vectorized compare-exchange kernels.
+template <typename T>
+concept SortingNetworkKey =
+    std::same_as<T, std::int32_t> || std::same_as<T, std::uint32_t> || std::same_as<T, float> ||
+    std::same_as<T, std::int64_t> || std::same_as<T, std::uint64_t> || std::same_as<T, double>;
+
+// Comparators equivalent to operator< on T, the only order the kernels implement.
+template <typename Compare, typename T>
+concept NaturalOrder = std::same_as<Compare, std::less<>> || std::same_as<Compare, std::less<T>> ||
+                       std::same_as<Compare, std::ranges::less>;
+
+/**
+ * @brief Whether the running CPU can execute the AVX2 kernels (checked once)
+ */
+inline bool sortingNetworkAvailable() {
+#if CLAVIS_HAS_AVX2_KERNELS
+  static const bool supported = __builtin_cpu_supports("avx2") != 0;
+  return supported;
+#else
+  return false;
+#endif
+}
+
+/**
+ * @brief Whether sorts over It with comp may use the vectorized kernels
+ */
+template <std::random_access_iterator It, typename Compare>
+bool sortingNetworkApplies() {
+  using T = std::iter_value_t<It>;
+  if constexpr (std::contiguous_iterator<It> && SortingNetworkKey<T> && NaturalOrder<Compare, T>) {
+    return sortingNetworkAvailable();
+  } else {
+    return false;
+  }
+}
+
+#if CLAVIS_HAS_AVX2_KERNELS
+
+// Number of T lanes in one 256-bit register.
+template <SortingNetworkKey T>
+inline constexpr int kSimdLanes = static_cast<int>(32 / sizeof(T));
+
+template <SortingNetworkKey T>
+CLAVIS_AVX2_TARGET inline __m256i simdMin(__m256i a, __m256i b) {
+  if constexpr (std::same_as<T, std::int32_t>) {
+    return _mm256_min_epi32(a, b);
+  } else if constexpr (std::same_as<T, std::uint32_t>) {
+    return _mm256_min_epu32(a, b);
+  } else if constexpr (std::same_as<T, float>) {
+    return _mm256_castps_si256(_mm256_min_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+  } else if constexpr (std::same_as<T, double>) {
+    return _mm256_castpd_si256(_mm256_min_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b)));
+  } else {
+    __m256i bias = std::same_as<T, std::uint64_t> ? _mm256_set1_epi64x(INT64_MIN)
+                                                  : _mm256_setzero_si256();
+    __m256i greater = _mm256_cmpgt_epi64(_mm256_xor_si256(a, bias), _mm256_xor_si256(b, bias));
+    return _mm256_blendv_epi8(a, b, greater);
+  }
+}
+
+template <SortingNetworkKey T>
+CLAVIS_AVX2_TARGET inline __m256i simdMax(__m256i a, __m256i b) {
+  if constexpr (std::same_as<T, std::int32_t>) {
+    return _mm256_max_epi32(a, b);
+  } else if constexpr (std::same_as<T, std::uint32_t>) {
+    return _mm256_max_epu32(a, b);
+  } else if constexpr (std::same_as<T, float>) {
+    return _mm256_castps_si256(_mm256_max_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+  } else if constexpr (std::same_as<T, double>) {
+    return _mm256_castpd_si256(_mm256_max_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b)));
+  } else {
+    __m256i bias = std::same_as<T, std::uint64_t> ? _mm256_set1_epi64x(INT64_MIN)
+                                                  : _mm256_setzero_si256();
+    __m256i greater = _mm256_cmpgt_epi64(_mm256_xor_si256(a, bias), _mm256_xor_si256(b, bias));
+    return _mm256_blendv_epi8(b, a, greater);
+  }
+}
+
+// 32-bit source position feeding 32-bit position j when T lane l moves to l ^ M.
+template <SortingNetworkKey T, int M>
+constexpr int simdXorIndex(int j) {
+  if constexpr (sizeof(T) == 4) {
+    return j ^ M;
+  } else {
+    return 2 * ((j >> 1) ^ M) + (j & 1);
+  }
+}
+
+// Exchanges every T lane l with lane l ^ M.
+template <SortingNetworkKey T, int M>
+CLAVIS_AVX2_TARGET inline __m256i simdPermuteXor(__m256i v) {
+  if constexpr (M == 0) {
+    return v;
+  } else {
+    const __m256i index = _mm256_setr_epi32(
+        simdXorIndex<T, M>(0), simdXorIndex<T, M>(1), simdXorIndex<T, M>(2),
+        simdXorIndex<T, M>(3), simdXorIndex<T, M>(4), simdXorIndex<T, M>(5),
+        simdXorIndex<T, M>(6), simdXorIndex<T, M>(7));
+    return _mm256_permutevar8x32_epi32(v, index);
+  }
+}
+
+// Blend mask selecting the T lanes whose index has bit H set.
+template <SortingNetworkKey T, int H>
+constexpr int simdHighLaneMask() {
+  int mask = 0;
+  for (int j = 0; j < 8; ++j) {
+    if (((j / static_cast<int>(sizeof(T) / 4)) & H) != 0) {
+      mask |= 1 << j;
+    }
+  }
+  return mask;
+}
+
+/**
+ * @brief Compare-exchange of every element i with element i ^ M across the
+ *        R registers holding R * kSimdLanes<T> elements; the smaller value
+ *        ends at the lower index
+ */
+template <SortingNetworkKey T, int R, int M>
+CLAVIS_AVX2_TARGET inline void simdCompareExchangeXor(__m256i (&v)[R]) {
+  constexpr int lanes = kSimdLanes<T>;
+  if constexpr (M < lanes) {
+    constexpr int mask = simdHighLaneMask<T, static_cast<int>(std::bit_floor(unsigned{M}))>();
+    for (int r = 0; r < R; ++r) {
+      __m256i partner = simdPermuteXor<T, M>(v[r]);
+      __m256i lo = simdMin<T>(v[r], partner);
+      __m256i hi = simdMax<T>(v[r], partner);
+      v[r] = _mm256_blend_epi32(lo, hi, mask);
+    }
+  } else {
+    constexpr int registerXor = M / lanes;
+    constexpr int laneXor = M % lanes;
+    constexpr int registerHigh = static_cast<int>(std::bit_floor(unsigned{registerXor}));
+    for (int r = 0; r < R; ++r) {
+      if ((r & registerHigh) != 0) {
+        continue;
+      }
+      int p = r ^ registerXor;
+      __m256i partner = simdPermuteXor<T, laneXor>(v[p]);
+      // Swapped operands keep the exchange a permutation when a NaN makes
+      // min and max both return their second operand.
+      __m256i lo = simdMin<T>(v[r], partner);
+      __m256i hi = simdMax<T>(partner, v[r]);
+      v[r] = lo;
+      v[p] = simdPermuteXor<T, laneXor>(hi);
+    }
+  }
+}
+
+template <SortingNetworkKey T, int R, int J>
+CLAVIS_AVX2_TARGET inline void simdHalfCleaners(__m256i (&v)[R]) {
+  if constexpr (J >= 1) {
+    simdCompareExchangeXor<T, R, J>(v);
+    simdHalfCleaners<T, R, J / 2>(v);
+  }
+}
+
+/**
+ * @brief Merges neighbouring sorted blocks of K / 2 elements into sorted
+ *        blocks of K: a flip stage pairing i with i ^ (K - 1) followed by
+ *        half-cleaners, so every comparator sends the minimum down
+ */
+template <SortingNetworkKey T, int R, int K>
+CLAVIS_AVX2_TARGET inline void simdBitonicMerge(__m256i (&v)[R]) {
+  simdCompareExchangeXor<T, R, K - 1>(v);
+  simdHalfCleaners<T, R, K / 4>(v);
+}
+
+template <SortingNetworkKey T, int R, int K = 2>
+CLAVIS_AVX2_TARGET inline void simdBitonicSort(__m256i (&v)[R]) {
+  if constexpr (K <= R * kSimdLanes<T>) {
+    simdBitonicMerge<T, R, K>(v);
+    simdBitonicSort<T, R, 2 * K>(v);
+  }
+}
+
+// Sorts n <= R * kSimdLanes<T> values, padding the block with the largest key.
+template <SortingNetworkKey T, int R>
+CLAVIS_AVX2_TARGET void simdSortBlock(T* data, std::size_t n) {
+  constexpr int lanes = kSimdLanes<T>;
+  alignas(32) T block[R * lanes];
+  std::copy_n(data, n, block);
+  constexpr T padding = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                             : std::numeric_limits<T>::max();
+  std::fill(block + n, block + R * lanes, padding);
+  __m256i v[R];
+  for (int r = 0; r < R; ++r) {
+    v[r] = _mm256_load_si256(reinterpret_cast<const __m256i*>(block + r * lanes));
+  }
+  simdBitonicSort<T, R>(v);
+  for (int r = 0; r < R; ++r) {
+    _mm256_store_si256(reinterpret_cast<__m256i*>(block + r * lanes), v[r]);
+  }
+  std::copy_n(block, n, data);
+}
+
+/**
+ * @brief Merges sorted a[0, na) and b[0, nb) into out with a two-register
+ *        bitonic merge network, kSimdLanes<T> outputs per step
+ *
+ * Each step emits the lower half of the merged registers and refills the other
+ * register from the input whose next key is smaller. The last partial
+ * registers are merged with scalar code.
+ */
+template <SortingNetworkKey T>
+CLAVIS_AVX2_TARGET void simdMergeRuns(const T* a, std::size_t na, const T* b, std::size_t nb,
+                                      T* out) {
+  constexpr std::size_t lanes = kSimdLanes<T>;
+  std::size_t i = 0;
+  std::size_t j = 0;
+  alignas(32) T pending[lanes];
+  std::size_t pendingSize = 0;
+  if (na >= lanes && nb >= lanes) {
+    __m256i v[2] = {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a)),
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b))};
+    i = j = lanes;
+    for (;;) {
+      simdBitonicMerge<T, 2, 2 * lanes>(v);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), v[0]);
+      out += lanes;
+      // Refill from the input with the smaller next key; stop once that input
+      // cannot supply a full register.
+      bool fromA = j == nb || (i < na && !(b[j] < a[i]));
+      if (fromA ? i + lanes > na : j + lanes > nb) {
+        break;
+      }
+      const T* next = fromA ? a + i : b + j;
+      (fromA ? i : j) += lanes;
+      v[0] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(next));
+    }
+    _mm256_store_si256(reinterpret_cast<__m256i*>(pending), v[1]);
+    pendingSize = lanes;
+  }
+
+  // Scalar tail: pending and the rest of a and b are each sorted. The source
+  // is tracked by its counter, not by address: adjacent runs make a + na and
+  // b the same pointer.
+  std::size_t k = 0;
+  while (k < pendingSize || i < na || j < nb) {
+    std::size_t* source = k < pendingSize ? &k : nullptr;
+    const T* best = k < pendingSize ? pending + k : nullptr;
+    if (i < na && (best == nullptr || a[i] < *best)) {
+      source = &i;
+      best = a + i;
+    }
+    if (j < nb && (best == nullptr || b[j] < *best)) {
+      source = &j;
+      best = b + j;
+    }
+    *out++ = *best;
+    ++*source;
+  }
+}
+
+#endif  // CLAVIS_HAS_AVX2_KERNELS
+
+/**
+ * @brief Sorts n <= kSortingNetworkMaxSize values with an AVX2 bitonic
+ *        sorting network on blocks of 8, 16, 32 or 64 elements
+ *
+ * Falls back to insertion sort when the CPU lacks AVX2. NaNs are not ordered
+ * but are kept: the output is a permutation of the input.
+ */
+template <SortingNetworkKey T>
+void sortingNetworkSort(T* data, std::size_t n) {
+#if CLAVIS_HAS_AVX2_KERNELS
+  if (sortingNetworkAvailable() && n <= static_cast<std::size_t>(kSortingNetworkMaxSize)) {
+    constexpr std::size_t lanes = kSimdLanes<T>;
+    if constexpr (std::floating_point<T>) {
+      // A NaN is unordered against the padding and could trade places with it,
+      // so NaNs are moved behind the range the network sorts.
+      n = static_cast<std::size_t>(std::partition(data, data + n, [](T x) { return x == x; }) -
+                                   data);
+    }
+    if (n <= 8) {
+      simdSortBlock<T, static_cast<int>(8 / lanes)>(data, n);
+    } else if (n <= 16) {
+      simdSortBlock<T, static_cast<int>(16 / lanes)>(data, n);
+    } else if (n <= 32) {
+      simdSortBlock<T, static_cast<int>(32 / lanes)>(data, n);
+    } else {
+      simdSortBlock<T, static_cast<int>(64 / lanes)>(data, n);
+    }
+    return;
+  }
+#endif
+  insertionSortImpl(data, data + n, std::less<>{});
+}
+
+/**
+ * @brief Base-case sort shared by the divide-and-conquer sorts: sorting
+ *        networks for eligible keys, insertion sort otherwise
+ *
+ * Observed sorts always take the insertion sort path so their counts stay
+ * comparable across key types.
+ */
+template <std::random_access_iterator It, typename Compare,
+          SortObserver Observer = NullSortObserver>
+void smallSort(It first, It last, Compare comp, Observer observer = {}) {
+  using T = std::iter_value_t<It>;
+  if constexpr (std::contiguous_iterator<It> && SortingNetworkKey<T> &&
+                NaturalOrder<Compare, T> && std::same_as<Observer, NullSortObserver>) {
+    if (last - first <= kSortingNetworkMaxSize && sortingNetworkApplies<It, Compare>()) {
+      sortingNetworkSort(std::to_address(first), static_cast<std::size_t>(last - first));
+      return;
+    }
+  }
+  insertionSortImpl(first, last, comp, observer);
+}
+
+#endif  // SORTING_NETWORK_HPP
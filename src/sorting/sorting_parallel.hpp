@@ -0,0 +1,143 @@
+#ifndef SORTING_PARALLEL_HPP
+#define SORTING_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Resolves a requested worker count
+ *
+ * @param threads Requested number of threads; 0 selects the hardware concurrency
+ * @return At least one thread
+ */
+inline std::size_t resolveThreadCount(std::size_t threads) {
+  if (threads == 0) {
+    threads = std::thread::hardware_concurrency();
+  }
+  return std::max<std::size_t>(threads, 1);
+}
+
+/**
+ * @brief Runs body(t) for every t in [0, threads) on its own thread
+ *
+ * The calling thread runs t == 0. The first exception thrown by any body is
+ * rethrown after all threads have joined.
+ */
+template <typename Body>
+void parallelFor(std::size_t threads, Body&& body) {
+  if (threads <= 1) {
+    body(std::size_t{0});
+    return;
+  }
+  std::exception_ptr error;
+  std::mutex errorMutex;
+  auto guarded = [&](std::size_t t) {
+    try {
+      body(t);
+    } catch (...) {
+      std::scoped_lock lock(errorMutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  };
+  {
+    std::vector<std::jthread> workers;
+    workers.reserve(threads - 1);
+    for (std::size_t t = 1; t < threads; ++t) {
+      workers.emplace_back(guarded, t);
+    }
+    guarded(0);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+/**
+ * @brief Returns the half-open bounds of chunk t when n items are split into
+ *        `chunks` contiguous, nearly equal pieces
+ */
+inline std::pair<std::size_t, std::size_t> chunkBounds(std::size_t n, std::size_t chunks,
+                                                       std::size_t t) {
+  return {n * t / chunks, n * (t + 1) / chunks};
+}
+
+/**
+ * @brief Work-stealing task scheduler for fork-join recursion
+ *
+ * Each worker owns a deque: it pushes and pops spawned tasks at the back
+ * (depth-first, cache-warm) while idle workers steal from the front of other
+ * deques, where the oldest and therefore largest tasks live.
+ *
+ * @param threads Number of workers, including the calling thread
+ * @param seeds Initial tasks, distributed round-robin
+ * @param body Callable invoked as body(task, spawn); spawn(Task) forks a task
+ */
+template <typename Task, typename Body>
+void runWorkStealing(std::size_t threads, std::vector<Task> seeds, Body&& body) {
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+  std::vector<WorkerQueue> queues(threads);
+  std::atomic<std::size_t> pending{seeds.size()};
+  std::atomic<bool> failed{false};
+  for (std::size_t i = 0; i < seeds.size(); ++i) {
+    queues[i % threads].tasks.push_back(std::move(seeds[i]));
+  }
+
+  auto take = [&](std::size_t self) -> std::optional<Task> {
+    {
+      std::scoped_lock lock(queues[self].mutex);
+      if (!queues[self].tasks.empty()) {
+        Task task = std::move(queues[self].tasks.back());
+        queues[self].tasks.pop_back();
+        return task;
+      }
+    }
+    for (std::size_t k = 1; k < threads; ++k) {
+      WorkerQueue& victim = queues[(self + k) % threads];
+      std::scoped_lock lock(victim.mutex);
+      if (!victim.tasks.empty()) {
+        Task task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return task;
+      }
+    }
+    return std::nullopt;
+  };
+
+  parallelFor(threads, [&](std::size_t self) {
+    auto spawn = [&](Task task) {
+      pending.fetch_add(1, std::memory_order_relaxed);
+      std::scoped_lock lock(queues[self].mutex);
+      queues[self].tasks.push_back(std::move(task));
+    };
+    while (pending.load(std::memory_order_acquire) != 0 &&
+           !failed.load(std::memory_order_relaxed)) {
+      std::optional<Task> task = take(self);
+      if (!task) {
+        std::this_thread::yield();
+        continue;
+      }
+      try {
+        body(std::move(*task), spawn);
+      } catch (...) {
+        failed.store(true, std::memory_order_relaxed);
+        throw;
+      }
+      pending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+  });
+}
+
+#endif  // SORTING_PARALLEL_HPP
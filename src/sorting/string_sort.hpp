@@ -0,0 +1,454 @@
+#ifndef STRING_SORT_HPP
+#define STRING_SORT_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "argsort.hpp"
+#include "insertion_sort.hpp"
+
+// Ranges at or below this size are insertion sorted from the current depth.
+inline constexpr std::ptrdiff_t kStringSortInsertionThreshold = 16;
+// Buckets at or below this size leave MSD radix sort for multikey quicksort.
+inline constexpr std::ptrdiff_t kMsdStringSortThreshold = 256;
+// One bucket per byte value plus bucket 0 for strings that have ended.
+inline constexpr std::size_t kStringSortBuckets = 257;
+// String bytes packed into each cached word; the low byte holds the length.
+inline constexpr std::size_t kStringSortWordBytes = 7;
+
+// Iterators whose elements, after proj, can be viewed as strings without a
+// temporary: a reference, a std::string_view or a C string.
+template <typename It, typename Proj = std::identity>
+concept StringSortable =
+    std::random_access_iterator<It> && std::permutable<It> &&
+    std::convertible_to<std::indirect_result_t<Proj&, It>, std::string_view> &&
+    (std::is_reference_v<std::indirect_result_t<Proj&, It>> ||
+     std::is_trivially_copyable_v<std::remove_cvref_t<std::indirect_result_t<Proj&, It>>>);
+
+/**
+ * @brief Up to kStringSortWordBytes bytes of s from depth on, packed so that
+ *        words compare like the corresponding suffixes of s
+ *
+ * The bytes fill the word from the top, zero padded, and the low byte holds
+ * how many of them s actually has. A string that ends inside the word thus
+ * sorts before any longer string with the same bytes, and two words are
+ * equal with a full length byte only if both strings go on past the word.
+ */
+inline std::uint64_t stringSortWord(std::string_view s, std::size_t depth) {
+  std::size_t length = depth < s.size() ? std::min(s.size() - depth, kStringSortWordBytes) : 0;
+  std::uint64_t word = 0;
+  for (std::size_t i = 0; i < length; ++i) {
+    word |= std::uint64_t{static_cast<unsigned char>(s[depth + i])} << (56 - 8 * i);
+  }
+  return word | length;
+}
+
+/**
+ * @brief Whether a word from stringSortWord leaves bytes of its string
+ *        beyond the word
+ */
+inline bool stringSortWordIsFull(std::uint64_t word) {
+  return (word & 0xff) == kStringSortWordBytes;
+}
+
+/**
+ * @brief Length of the common prefix of a and b, starting the scan at from
+ *
+ * Compares eight bytes at a time.
+ */
+inline std::size_t stringCommonPrefix(std::string_view a, std::string_view b,
+                                      std::size_t from = 0) {
+  auto limit = std::min(a.size(), b.size());
+  if constexpr (std::endian::native == std::endian::little) {
+    while (from + 8 <= limit) {
+      std::uint64_t x;
+      std::uint64_t y;
+      std::memcpy(&x, a.data() + from, 8);
+      std::memcpy(&y, b.data() + from, 8);
+      if (x != y) {
+        return from + static_cast<std::size_t>(std::countr_zero(x ^ y)) / 8;
+      }
+      from += 8;
+    }
+  }
+  while (from < limit && a[from] == b[from]) {
+    ++from;
+  }
+  return from;
+}
+
+/**
+ * @brief Insertion sort of strings that all share their first depth bytes,
+ *        comparing only what follows
+ */
+template <std::random_access_iterator It, typename Key>
+void stringInsertionSort(It first, It last, std::size_t depth, const Key& key) {
+  insertionSortImpl(first, last, [&key, depth](const auto& a, const auto& b) {
+    return key(a).substr(depth) < key(b).substr(depth);
+  });
+}
+
+/**
+ * @brief Caching multikey quicksort (three-way radix quicksort) of strings
+ *        that all share their first depth bytes
+ *
+ * words[i] caches stringSortWord of first[i] at depth and is permuted along
+ * with it. Partitioning on whole words into less, equal and greater parts
+ * reads only the contiguous cache; the less and greater parts keep their
+ * words, and only the equal part, whose strings share the next
+ * kStringSortWordBytes bytes, reloads its words from the strings at the
+ * following depth. Each byte of a common prefix is therefore fetched from
+ * the string about once per kStringSortWordBytes bytes instead of once per
+ * comparison. The largest part is handled by the loop and the other two by
+ * recursion.
+ */
+template <std::random_access_iterator It, typename Key>
+void multikeyQuickSortImpl(It first, std::span<std::uint64_t> words, std::size_t depth,
+                           const Key& key) {
+  auto swapAt = [&](std::size_t i, std::size_t j) {
+    std::swap(words[i], words[j]);
+    std::iter_swap(first + static_cast<std::ptrdiff_t>(i), first + static_cast<std::ptrdiff_t>(j));
+  };
+  while (static_cast<std::ptrdiff_t>(words.size()) > kStringSortInsertionThreshold) {
+    std::size_t n = words.size();
+    std::uint64_t a = words[0];
+    std::uint64_t b = words[n / 2];
+    std::uint64_t c = words[n - 1];
+    std::uint64_t pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+
+    std::size_t less = 0;
+    std::size_t i = 0;
+    std::size_t greater = n;
+    while (i < greater) {
+      if (words[i] < pivot) {
+        swapAt(less++, i++);
+      } else if (words[i] > pivot) {
+        swapAt(i, --greater);
+      } else {
+        ++i;
+      }
+    }
+
+    struct Part {
+      std::size_t first;
+      std::size_t last;
+      std::size_t depth;
+    };
+    std::array<Part, 3> parts{
+        {{0, less, depth}, {greater, n, depth}, {less, greater, depth + kStringSortWordBytes}}};
+    // Strings equal to a pivot that is not full have all ended.
+    if (!stringSortWordIsFull(pivot)) {
+      parts[2].last = parts[2].first;
+    }
+    for (std::size_t j = parts[2].first; j < parts[2].last; ++j) {
+      words[j] = stringSortWord(key(first[static_cast<std::ptrdiff_t>(j)]), parts[2].depth);
+    }
+    std::ranges::sort(parts, std::ranges::greater{},
+                      [](const Part& p) { return p.last - p.first; });
+    for (const Part& part : std::span{parts}.subspan(1)) {
+      multikeyQuickSortImpl(first + static_cast<std::ptrdiff_t>(part.first),
+                            words.subspan(part.first, part.last - part.first), part.depth, key);
+    }
+    first += static_cast<std::ptrdiff_t>(parts[0].first);
+    words = words.subspan(parts[0].first, parts[0].last - parts[0].first);
+    depth = parts[0].depth;
+  }
+
+  // Insertion sort on the cached words, falling back to the strings on ties.
+  for (std::size_t i = 1; i < words.size(); ++i) {
+    std::uint64_t word = words[i];
+    auto value = std::move(first[static_cast<std::ptrdiff_t>(i)]);
+    auto precedes = [&](std::size_t j) {
+      if (word != words[j]) {
+        return word < words[j];
+      }
+      return stringSortWordIsFull(word) &&
+             key(value).substr(depth) < key(first[static_cast<std::ptrdiff_t>(j)]).substr(depth);
+    };
+    std::size_t j = i;
+    for (; j > 0 && precedes(j - 1); --j) {
+      words[j] = words[j - 1];
+      first[static_cast<std::ptrdiff_t>(j)] = std::move(first[static_cast<std::ptrdiff_t>(j - 1)]);
+    }
+    words[j] = word;
+    first[static_cast<std::ptrdiff_t>(j)] = std::move(value);
+  }
+}
+
+/**
+ * @brief MSD radix sort of strings that all share their first depth bytes,
+ *        driven by cached words
+ *
+ * Each level loads stringSortWord of every string once into words and finds,
+ * from the cache alone, the first byte at which the strings do not all
+ * agree. Levels where every string has the same byte thus cost nothing, and
+ * long shared prefixes such as URL schemes and hosts are crossed
+ * kStringSortWordBytes bytes per scan. The strings are then counted and
+ * distributed through buffer by that byte, again read from the cache.
+ * Buckets at or below kMsdStringSortThreshold are finished by multikey
+ * quicksort on the words already loaded.
+ *
+ * @param buffer, words Scratch space of at least last - first elements
+ */
+template <std::random_access_iterator It, typename Key>
+void msdStringSortImpl(It first, It last, std::size_t depth, const Key& key,
+                       std::span<std::iter_value_t<It>> buffer, std::span<std::uint64_t> words) {
+  auto n = static_cast<std::size_t>(last - first);
+  words = words.first(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    words[i] = stringSortWord(key(first[static_cast<std::ptrdiff_t>(i)]), depth);
+  }
+  if (static_cast<std::ptrdiff_t>(n) <= kMsdStringSortThreshold) {
+    multikeyQuickSortImpl(first, words, depth, key);
+    return;
+  }
+
+  // Skip the bytes every string shares. A string ending at minLength is the
+  // first to differ from the others there, if they do not differ before.
+  std::size_t offset = 0;
+  for (;;) {
+    std::uint64_t differ = 0;
+    std::uint64_t minLength = kStringSortWordBytes;
+    for (std::uint64_t word : words) {
+      differ |= word ^ words[0];
+      minLength = std::min(minLength, word & 0xff);
+    }
+    if (differ != 0) {
+      offset = std::min<std::size_t>(static_cast<std::size_t>(std::countl_zero(differ)) / 8,
+                                     minLength);
+      break;
+    }
+    if (!stringSortWordIsFull(words[0])) {
+      return;
+    }
+    depth += kStringSortWordBytes;
+    for (std::size_t i = 0; i < n; ++i) {
+      words[i] = stringSortWord(key(first[static_cast<std::ptrdiff_t>(i)]), depth);
+    }
+  }
+  auto bucketOf = [offset](std::uint64_t word) -> std::size_t {
+    return (word & 0xff) > offset ? ((word >> (56 - 8 * offset)) & 0xff) + 1 : 0;
+  };
+
+  std::array<std::size_t, kStringSortBuckets + 1> offsets{};
+  for (std::uint64_t word : words) {
+    ++offsets[bucketOf(word) + 1];
+  }
+  for (std::size_t b = 1; b <= kStringSortBuckets; ++b) {
+    offsets[b] += offsets[b - 1];
+  }
+  std::array<std::size_t, kStringSortBuckets + 1> bounds = offsets;
+  for (std::size_t i = 0; i < n; ++i) {
+    buffer[offsets[bucketOf(words[i])]++] = std::move(first[static_cast<std::ptrdiff_t>(i)]);
+  }
+  std::move(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(n), first);
+  for (std::size_t b = 1; b < kStringSortBuckets; ++b) {
+    auto bucketFirst = first + static_cast<std::ptrdiff_t>(bounds[b]);
+    auto bucketLast = first + static_cast<std::ptrdiff_t>(bounds[b + 1]);
+    if (bucketLast - bucketFirst > 1) {
+      msdStringSortImpl(bucketFirst, bucketLast, depth + offset + 1, key, buffer, words);
+    }
+  }
+}
+
+/**
+ * @brief Stable LCP merge sort of items by key
+ *
+ * Alongside the sorted items, lcps[i] receives the length of the common
+ * prefix of items i - 1 and i. Merging compares those lengths first: the
+ * run whose head shares the longer prefix with the last output goes next
+ * without touching a character, and otherwise the strings are compared only
+ * from the shared length on. Every byte of the input is therefore compared
+ * O(log n) times at most, however long the common prefixes.
+ *
+ * @param buffer, lcpBuffer Scratch space of at least items.size() elements
+ */
+template <typename Item, typename Key>
+void lcpMergeSortImpl(std::span<Item> items, std::span<std::size_t> lcps, std::span<Item> buffer,
+                      std::span<std::size_t> lcpBuffer, const Key& key) {
+  std::size_t n = items.size();
+  if (static_cast<std::ptrdiff_t>(n) <= kStringSortInsertionThreshold) {
+    stringInsertionSort(items.begin(), items.end(), 0, key);
+    for (std::size_t i = 0; i < n; ++i) {
+      lcps[i] = i == 0 ? 0 : stringCommonPrefix(key(items[i - 1]), key(items[i]));
+    }
+    return;
+  }
+  std::size_t mid = n / 2;
+  lcpMergeSortImpl(items.first(mid), lcps.first(mid), buffer, lcpBuffer, key);
+  lcpMergeSortImpl(items.subspan(mid), lcps.subspan(mid), buffer, lcpBuffer, key);
+
+  // lcpA and lcpB are the common prefixes of the run heads with the last output.
+  std::size_t i = 0;
+  std::size_t j = mid;
+  std::size_t out = 0;
+  std::size_t lcpA = 0;
+  std::size_t lcpB = 0;
+  auto take = [&](std::size_t& from, std::size_t& lcp, std::size_t newLcp) {
+    buffer[out] = std::move(items[from]);
+    lcpBuffer[out++] = lcp;
+    ++from;
+    lcp = newLcp;
+  };
+  while (i < mid && j < n) {
+    if (lcpA > lcpB) {
+      take(i, lcpA, i + 1 < mid ? lcps[i + 1] : 0);
+    } else if (lcpB > lcpA) {
+      take(j, lcpB, j + 1 < n ? lcps[j + 1] : 0);
+    } else {
+      std::string_view a = key(items[i]);
+      std::string_view b = key(items[j]);
+      std::size_t common = stringCommonPrefix(a, b, lcpA);
+      if (a.substr(common) <= b.substr(common)) {
+        take(i, lcpA, i + 1 < mid ? lcps[i + 1] : 0);
+        lcpB = common;
+      } else {
+        take(j, lcpB, j + 1 < n ? lcps[j + 1] : 0);
+        lcpA = common;
+      }
+    }
+  }
+  for (; i < mid; lcpA = i < mid ? lcps[i] : 0) {
+    take(i, lcpA, 0);
+  }
+  for (; j < n; lcpB = j < n ? lcps[j] : 0) {
+    take(j, lcpB, 0);
+  }
+  std::ranges::move(buffer.first(n), items.begin());
+  std::ranges::copy(lcpBuffer.first(n), lcps.begin());
+  lcps[0] = 0;
+}
+
+/**
+ * @brief Runs engine over string views of proj applied to [first, last) and
+ *        leaves [first, last) in the order it produced
+ *
+ * A range of std::string_view is sorted directly. Anything else is sorted as
+ * (view, index) pairs, so strings are neither copied nor dereferenced through
+ * their owning objects, and the result is applied with one gather.
+ *
+ * @param engine Called as engine(begin, end, key) on iterators over items,
+ *        where key(item) returns the item's std::string_view
+ */
+template <std::random_access_iterator It, typename Proj, typename Engine>
+void sortStringKeys(It first, It last, Proj proj, Engine engine) {
+  if constexpr (std::same_as<std::iter_value_t<It>, std::string_view> &&
+                std::same_as<Proj, std::identity>) {
+    engine(first, last, [](std::string_view s) { return s; });
+  } else {
+    struct StringRef {
+      std::string_view key;
+      std::size_t index;
+    };
+    auto n = static_cast<std::size_t>(last - first);
+    std::vector<StringRef> refs;
+    refs.reserve(n);
+    std::size_t index = 0;
+    for (It it = first; it != last; ++it) {
+      refs.push_back({std::string_view(std::invoke(proj, *it)), index++});
+    }
+    engine(refs.begin(), refs.end(), [](const StringRef& ref) { return ref.key; });
+    std::vector<std::size_t> order(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      order[i] = refs[i].index;
+    }
+    applyPermutation(order, std::ranges::subrange(first, last));
+  }
+}
+
+/**
+ * @brief Sorts [first, last) by the strings proj views in each element with
+ *        multikey quicksort
+ *
+ * In place apart from the key array and one cached word per element; a good
+ * default for small and medium inputs. Not stable.
+ */
+template <std::random_access_iterator It, typename Proj = std::identity>
+  requires StringSortable<It, Proj>
+void multikeyQuickSort(It first, It last, Proj proj = {}) {
+  sortStringKeys(first, last, proj, [](auto begin, auto end, auto key) {
+    std::vector<std::uint64_t> words;
+    words.reserve(static_cast<std::size_t>(end - begin));
+    for (auto it = begin; it != end; ++it) {
+      words.push_back(stringSortWord(key(*it), 0));
+    }
+    multikeyQuickSortImpl(begin, std::span{words}, 0, key);
+  });
+}
+
+template <std::ranges::random_access_range R, typename Proj = std::identity>
+  requires StringSortable<std::ranges::iterator_t<R>, Proj>
+void multikeyQuickSort(R&& range, Proj proj = {}) {
+  auto first = std::ranges::begin(range);
+  multikeyQuickSort(first, std::ranges::next(first, std::ranges::end(range)), proj);
+}
+
+/**
+ * @brief Sorts [first, last) by the strings proj views in each element with
+ *        MSD radix sort over cached words
+ *
+ * Fastest on large inputs. Needs a key array, a scratch copy of it and one
+ * cached word per element; no string is copied. Not stable.
+ */
+template <std::random_access_iterator It, typename Proj = std::identity>
+  requires StringSortable<It, Proj>
+void msdStringSort(It first, It last, Proj proj = {}) {
+  sortStringKeys(first, last, proj, [](auto begin, auto end, auto key) {
+    auto n = static_cast<std::size_t>(end - begin);
+    std::vector<std::iter_value_t<decltype(begin)>> buffer(n);
+    std::vector<std::uint64_t> words(n);
+    msdStringSortImpl(begin, end, 0, key, std::span{buffer}, std::span{words});
+  });
+}
+
+template <std::ranges::random_access_range R, typename Proj = std::identity>
+  requires StringSortable<std::ranges::iterator_t<R>, Proj>
+void msdStringSort(R&& range, Proj proj = {}) {
+  auto first = std::ranges::begin(range);
+  msdStringSort(first, std::ranges::next(first, std::ranges::end(range)), proj);
+}
+
+/**
+ * @brief Stable sort of [first, last) by the strings proj views in each
+ *        element with LCP merge sort
+ *
+ * The stable choice among the string sorts: equal strings keep their input
+ * order. Needs the key array, a scratch copy and two prefix-length arrays.
+ */
+template <std::random_access_iterator It, typename Proj = std::identity>
+  requires StringSortable<It, Proj>
+void lcpMergeSort(It first, It last, Proj proj = {}) {
+  sortStringKeys(first, last, proj, [](auto begin, auto end, auto key) {
+    using Item = std::iter_value_t<decltype(begin)>;
+    auto n = static_cast<std::size_t>(end - begin);
+    std::vector<Item> items(std::make_move_iterator(begin), std::make_move_iterator(end));
+    std::vector<Item> buffer(n);
+    std::vector<std::size_t> lcps(n);
+    std::vector<std::size_t> lcpBuffer(n);
+    lcpMergeSortImpl(std::span{items}, std::span{lcps}, std::span{buffer}, std::span{lcpBuffer},
+                     key);
+    std::ranges::move(items, begin);
+  });
+}
+
+template <std::ranges::random_access_range R, typename Proj = std::identity>
+  requires StringSortable<std::ranges::iterator_t<R>, Proj>
+void lcpMergeSort(R&& range, Proj proj = {}) {
+  auto first = std::ranges::begin(range);
+  lcpMergeSort(first, std::ranges::next(first, std::ranges::end(range)), proj);
+}
+
+#endif  // STRING_SORT_HPP
@@ -2,6 +2,11 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
 class FenwickTreeTest : public ::testing::Test {
  protected:
   // No special setup needed here, but we could create common data if required
@@ -53,3 +58,81 @@ TEST_F(FenwickTreeTest, LargeUpdates) {
   // sum of [1..3] => arr[1] + arr[2] + arr[3] = -5 + 0 + 5 = 0
   EXPECT_EQ(fenw.rangeQuery(1, 3), 0);
 }
+
+TEST_F(FenwickTreeTest, SixtyFourBitCountersDoNotOverflow) {
+  FenwickTree<std::int64_t> fenw(4);
+  fenw.update(0, std::int64_t{1} << 40);
+  fenw.update(2, std::int64_t{3} << 31);
+  EXPECT_EQ(fenw.query(3), (std::int64_t{1} << 40) + (std::int64_t{3} << 31));
+  EXPECT_EQ(fenw.rangeQuery(1, 3), std::int64_t{3} << 31);
+
+  FenwickTree<double> weights(3);
+  weights.update(1, 0.25);
+  weights.update(2, 0.5);
+  EXPECT_DOUBLE_EQ(weights.query(2), 0.75);
+}
+
+TEST_F(FenwickTreeTest, LinearBuildMatchesUpdates) {
+  std::mt19937 gen(7);
+  for (std::size_t n : {0u, 1u, 2u, 7u, 64u, 1000u}) {
+    std::vector<std::uint64_t> values(n);
+    for (auto& v : values) v = gen() % 1000;
+    FenwickTree built(values);
+    FenwickTree<std::uint64_t> updated(n);
+    for (std::size_t i = 0; i < n; ++i) updated.update(i, values[i]);
+    EXPECT_EQ(built.size(), n);
+    for (std::size_t i = 0; i < n; ++i) {
+      EXPECT_EQ(built.query(i), updated.query(i)) << "Prefix mismatch at index " << i;
+    }
+  }
+}
+
+TEST_F(FenwickTreeTest, LowerBoundFindsFirstPrefixReachingSum) {
+  std::vector<std::uint64_t> counts = {3, 0, 2, 5, 0, 0, 1, 4};
+  FenwickTree fenw(counts);
+  std::uint64_t total = std::accumulate(counts.begin(), counts.end(), std::uint64_t{0});
+  for (std::uint64_t sum = 0; sum <= total + 1; ++sum) {
+    std::size_t expected = 0;
+    std::uint64_t prefix = 0;
+    while (expected < counts.size() && prefix + counts[expected] < sum) {
+      prefix += counts[expected++];
+    }
+    EXPECT_EQ(fenw.lowerBound(sum), expected) << "sum " << sum;
+  }
+
+  // Order statistics: the k-th smallest (1-based) of a multiset of values.
+  FenwickTree<int> histogram(10);
+  for (int value : {7, 2, 2, 9, 4}) histogram.update(value, 1);
+  EXPECT_EQ(histogram.lowerBound(1), 2u);
+  EXPECT_EQ(histogram.lowerBound(2), 2u);
+  EXPECT_EQ(histogram.lowerBound(3), 4u);
+  EXPECT_EQ(histogram.lowerBound(5), 9u);
+  EXPECT_EQ(histogram.lowerBound(6), 10u);
+}
+
+namespace {
+
+// Vectors in Z^2 under addition, a group type without an ordering.
+struct Vec2 {
+  long x = 0;
+  long y = 0;
+  Vec2 operator+(const Vec2& o) const { return {x + o.x, y + o.y}; }
+  Vec2 operator-(const Vec2& o) const { return {x - o.x, y - o.y}; }
+  Vec2& operator+=(const Vec2& o) {
+    x += o.x;
+    y += o.y;
+    return *this;
+  }
+  bool operator==(const Vec2&) const = default;
+};
+
+}  // namespace
+
+TEST_F(FenwickTreeTest, SumsUserGroupTypes) {
+  std::vector<Vec2> moves = {{1, 0}, {0, 2}, {-3, 1}, {2, 2}};
+  FenwickTree fenw(moves);
+  EXPECT_EQ(fenw.query(3), (Vec2{0, 5}));
+  EXPECT_EQ(fenw.rangeQuery(1, 2), (Vec2{-3, 3}));
+  fenw.update(1, {5, 5});
+  EXPECT_EQ(fenw.rangeQuery(1, 1), (Vec2{5, 7}));
+}
@@ -0,0 +1,150 @@
+#include "../../src/sorting/aggregate_sort.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../../src/sorting/sort_observer.hpp"
+
+TEST(SortUniqueTest, MatchesSortThenUnique) {
+  std::mt19937 gen(1);
+  for (std::size_t n : {0u, 1u, 31u, 33u, 1000u, 100000u}) {
+    std::vector<int> arr(n);
+    for (auto& x : arr) x = static_cast<int>(gen() % 500) - 250;
+    std::vector<int> expected = arr;
+    std::sort(expected.begin(), expected.end());
+    expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+    std::vector<int> merged = arr;
+    merged.erase(sortUnique(merged.begin(), merged.end()), merged.end());
+    EXPECT_EQ(merged, expected);
+    sortUnique(arr);
+    EXPECT_EQ(arr, expected);
+  }
+}
+
+TEST(SortUniqueTest, KeepsFirstOfEachGroupUnderProjection) {
+  using Entry = std::pair<std::string, int>;
+  std::mt19937 gen(2);
+  std::vector<Entry> entries;
+  for (int i = 0; i < 5000; ++i) entries.emplace_back("k" + std::to_string(gen() % 40), i);
+  std::map<std::string, int> firsts;
+  for (const auto& [key, index] : entries) firsts.try_emplace(key, index);
+  auto end = sortUnique(entries, std::ranges::less{}, &Entry::first);
+  entries.erase(end, entries.end());
+  ASSERT_EQ(entries.size(), firsts.size());
+  for (const auto& [key, index] : entries) EXPECT_EQ(index, firsts[key]);
+}
+
+TEST(SortReduceTest, FoldsPayloadsInInputOrder) {
+  struct Row {
+    int key;
+    std::vector<int> ids;
+  };
+  std::mt19937 gen(3);
+  std::vector<Row> rows;
+  std::map<int, std::vector<int>> expected;
+  for (int i = 0; i < 20000; ++i) {
+    int key = static_cast<int>(gen() % 300);
+    rows.push_back({key, {i}});
+    expected[key].push_back(i);
+  }
+  auto append = [](Row& kept, Row&& next) {
+    kept.ids.insert(kept.ids.end(), next.ids.begin(), next.ids.end());
+  };
+  auto end = sortReduce(rows, append, std::ranges::greater{}, &Row::key);
+  ASSERT_EQ(end - rows.begin(), static_cast<std::ptrdiff_t>(expected.size()));
+  auto it = expected.rbegin();
+  for (auto row = rows.begin(); row != end; ++row, ++it) {
+    EXPECT_EQ(row->key, it->first);
+    EXPECT_EQ(row->ids, it->second);
+  }
+}
+
+TEST(SortReduceTest, MovesFewerElementsThanSortThenUnique) {
+  std::mt19937 gen(4);
+  std::vector<std::string> words(50000);
+  for (auto& word : words) word = "w" + std::to_string(gen() % 100);
+  std::vector<std::string> copy = words;
+  SortStats fused;
+  sortUnique(words.begin(), words.end(), std::ranges::less{}, std::identity{},
+             CountingSortObserver{fused});
+  SortStats separate;
+  mergeSort(copy.begin(), copy.end(), std::ranges::less{}, std::identity{},
+            CountingSortObserver{separate});
+  EXPECT_LT(fused.moves, separate.moves / 2);
+}
+
+TEST(RadixSortReduceByTest, SumsRecordsWithEqualKeys) {
+  struct Sale {
+    std::int64_t item;
+    double amount;
+  };
+  std::mt19937 gen(5);
+  for (std::size_t n : {10u, 1000u, 200000u}) {
+    std::vector<Sale> sales(n);
+    std::map<std::int64_t, double> totals;
+    for (auto& sale : sales) {
+      sale = {static_cast<std::int64_t>(gen() % 5000) - 2500, static_cast<double>(gen() % 7)};
+      totals[sale.item] += sale.amount;
+    }
+    auto size = radixSortReduceBy(std::span<Sale>{sales}, &Sale::item,
+                                  [](Sale& kept, Sale&& next) { kept.amount += next.amount; });
+    ASSERT_EQ(size, totals.size());
+    auto it = totals.begin();
+    for (std::size_t i = 0; i < size; ++i, ++it) {
+      EXPECT_EQ(sales[i].item, it->first);
+      EXPECT_EQ(sales[i].amount, it->second);
+    }
+  }
+}
+
+TEST(RadixSortReduceByTest, CollapsesInputOfOneKey) {
+  std::vector<std::uint32_t> same(1000, 7);
+  sortUnique(same);
+  EXPECT_EQ(same, std::vector<std::uint32_t>{7});
+  std::vector<double> values = {2.5, -1.0, 2.5, 0.0, -1.0};
+  sortUnique(values);
+  EXPECT_EQ(values, (std::vector<double>{-1.0, 0.0, 2.5}));
+}
+
+TEST(RadixSortReduceByTest, FoldsSignedZerosLikeTheComparator) {
+  for (std::size_t n : {3u, 1000u}) {
+    std::vector<double> values(n);
+    for (std::size_t i = 0; i < n; ++i) values[i] = i % 3 == 2 ? 1.0 : (i % 3 == 0 ? -0.0 : 0.0);
+    auto counts = sortCount(values);
+    ASSERT_EQ(counts.size(), 2u) << "n = " << n;
+    EXPECT_EQ(counts[0].second, n - n / 3);
+    sortUnique(values);
+    ASSERT_EQ(values, (std::vector<double>{0.0, 1.0})) << "n = " << n;
+    // The first zero of the input is the one kept.
+    EXPECT_TRUE(std::signbit(values[0]));
+  }
+}
+
+TEST(SortCountTest, CountsRadixAndComparisonKeys) {
+  std::mt19937 gen(6);
+  std::vector<std::uint16_t> values(100000);
+  std::map<std::uint16_t, std::size_t> expected;
+  for (auto& value : values) ++expected[value = static_cast<std::uint16_t>(gen() % 1000)];
+  auto counts = sortCount(values);
+  ASSERT_EQ(counts.size(), expected.size());
+  EXPECT_TRUE(std::equal(counts.begin(), counts.end(), expected.begin(),
+                         [](const auto& a, const auto& b) {
+                           return a.first == b.first && a.second == b.second;
+                         }));
+
+  std::vector<std::string> words = {"b", "a", "c", "a", "b", "a"};
+  auto wordCounts = sortCount(words);
+  EXPECT_EQ(wordCounts, (std::vector<std::pair<std::string, std::size_t>>{
+                            {"a", 3}, {"b", 2}, {"c", 1}}));
+}
@@ -0,0 +1,91 @@
+#include "../../src/sorting/argsort.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST(ArgsortTest, ReturnsSortingPermutation) {
+  std::vector<int> keys = {30, 10, 20};
+  EXPECT_EQ(argsort(keys), (std::vector<std::uint32_t>{1, 2, 0}));
+}
+
+TEST(ArgsortTest, HandlesEmptyInput) {
+  std::vector<double> keys;
+  EXPECT_TRUE(argsort(keys).empty());
+}
+
+TEST(ArgsortTest, RadixPathIsStable) {
+  std::mt19937 gen(5);
+  std::vector<std::int32_t> keys(20000);
+  for (auto& k : keys) k = static_cast<std::int32_t>(gen() % 64) - 32;
+  auto order = argsort<std::uint64_t>(keys);
+  ASSERT_EQ(order.size(), keys.size());
+  for (std::size_t i = 1; i < order.size(); ++i) {
+    ASSERT_LE(keys[order[i - 1]], keys[order[i]]);
+    if (keys[order[i - 1]] == keys[order[i]]) {
+      EXPECT_LT(order[i - 1], order[i]);
+    }
+  }
+}
+
+TEST(ArgsortTest, ComparisonPathHonorsComparatorAndProjection) {
+  std::vector<std::string> keys = {"pear", "fig", "banana", "kiwi"};
+  auto length = [](const std::string& s) { return s.size(); };
+  auto order = argsort(keys, std::ranges::greater{}, length);
+  EXPECT_EQ(order, (std::vector<std::uint32_t>{2, 0, 3, 1}));
+}
+
+TEST(ArgsortTest, MatchesStableSortOfFloats) {
+  std::mt19937 gen(6);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<float> keys(5000);
+  for (auto& k : keys) k = dist(gen);
+  auto order = argsort(keys);
+  std::vector<float> sorted;
+  for (auto i : order) sorted.push_back(keys[i]);
+  EXPECT_TRUE(std::ranges::is_sorted(sorted));
+}
+
+TEST(ArgsortTest, KeepsInputOrderOfSignedZeros) {
+  EXPECT_EQ(argsort(std::vector<double>{0.0, -0.0}), (std::vector<std::uint32_t>{0, 1}));
+  std::vector<double> keys(1000);
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    keys[i] = i % 3 == 0 ? -0.0 : (i % 3 == 1 ? 0.0 : -1.0);
+  }
+  std::vector<std::uint32_t> expected(keys.size());
+  for (std::uint32_t i = 0; i < expected.size(); ++i) expected[i] = i;
+  std::ranges::stable_sort(expected, {}, [&keys](std::uint32_t i) { return keys[i]; });
+  EXPECT_EQ(argsort(keys), expected);
+}
+
+TEST(ArgsortTest, ApplyPermutationGathersColumn) {
+  std::vector<std::uint32_t> order = {2, 0, 1};
+  std::vector<std::string> column = {"a", "b", "c"};
+  applyPermutation(order, column);
+  EXPECT_EQ(column, (std::vector<std::string>{"c", "a", "b"}));
+
+  std::vector<std::string> tooShort = {"a"};
+  EXPECT_THROW(applyPermutation(order, tooShort), std::invalid_argument);
+}
+
+TEST(CoSortTest, ReordersEveryColumnByKey) {
+  std::vector<std::int64_t> ids = {3, 1, 2, 1};
+  std::vector<double> prices = {30.0, 10.0, 20.0, 11.0};
+  std::vector<std::string> names = {"c", "a", "b", "a2"};
+  coSort(ids, prices, names);
+  EXPECT_EQ(ids, (std::vector<std::int64_t>{1, 1, 2, 3}));
+  EXPECT_EQ(prices, (std::vector<double>{10.0, 11.0, 20.0, 30.0}));
+  EXPECT_EQ(names, (std::vector<std::string>{"a", "a2", "b", "c"}));
+}
+
+TEST(CoSortTest, RejectsMismatchedColumns) {
+  std::vector<int> keys = {1, 2, 3};
+  std::vector<int> column = {1, 2};
+  EXPECT_THROW(coSort(keys, column), std::invalid_argument);
+}
@@ -2,6 +2,10 @@
 
 #include <gtest/gtest.h>
 
+#include <functional>
+#include <span>
+#include <vector>
+
 TEST(BubbleSortTest, SortsIntegerArray) {
   std::vector<int> arr = {64, 34, 25, 12, 22, 11, 90};
   std::vector<int> expected = {11, 12, 22, 25, 34, 64, 90};
@@ -26,4 +30,10 @@ TEST(BubbleSortTest, HandlesRepeatedElements) {
   std::vector<int> expected = {1, 1, 3, 4, 5};
   bubbleSort(arr);
   EXPECT_EQ(arr, expected);
-}
\ No newline at end of file
+}
+
+TEST(BubbleSortTest, SortsSpanWithComparator) {
+  std::vector<int> arr = {9, 3, 1, 2, 0};
+  bubbleSort(std::span<int>{arr}.subspan(1, 3), std::ranges::greater{});
+  EXPECT_EQ(arr, (std::vector<int>{9, 3, 2, 1, 0}));
+}
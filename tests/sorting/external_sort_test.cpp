@@ -0,0 +1,131 @@
+#include "../../src/sorting/external_sort.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+class ExternalSortTest : public ::testing::Test {
+ protected:
+  std::filesystem::path dir;
+
+  void SetUp() override {
+    dir = std::filesystem::temp_directory_path() /
+          ("clavis-external-sort-test-" + std::to_string(std::random_device{}()));
+    std::filesystem::create_directories(dir);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(dir); }
+
+  template <typename T>
+  void writeRecords(const std::filesystem::path& path, const std::vector<T>& records) {
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(records.data()),
+              static_cast<std::streamsize>(records.size() * sizeof(T)));
+  }
+
+  template <typename T>
+  std::vector<T> readRecords(const std::filesystem::path& path) {
+    std::vector<T> records(std::filesystem::file_size(path) / sizeof(T));
+    std::ifstream in(path, std::ios::binary);
+    in.read(reinterpret_cast<char*>(records.data()),
+            static_cast<std::streamsize>(records.size() * sizeof(T)));
+    return records;
+  }
+};
+
+TEST_F(ExternalSortTest, SortsFileInMemory) {
+  std::vector<uint64_t> values = {42, 7, 19, 3, 88, 1};
+  writeRecords(dir / "in.bin", values);
+  auto stats = externalSort<uint64_t>(dir / "in.bin", dir / "out.bin");
+  std::sort(values.begin(), values.end());
+  EXPECT_EQ(readRecords<uint64_t>(dir / "out.bin"), values);
+  EXPECT_EQ(stats.runs, 1u);
+  EXPECT_EQ(stats.bytesWritten, values.size() * sizeof(uint64_t));
+}
+
+TEST_F(ExternalSortTest, SpillsAndMergesRunsInSeveralPasses) {
+  std::mt19937_64 gen(17);
+  std::vector<uint64_t> values(50000);
+  for (auto& x : values) x = gen();
+  writeRecords(dir / "in.bin", values);
+
+  ExternalSortOptions options;
+  options.memoryBudget = 16 * 1024;
+  options.ioBlockBytes = 2 * 1024;
+  options.tempDirectory = dir;
+  size_t callbacks = 0;
+  options.onProgress = [&](const ExternalSortProgress&) { ++callbacks; };
+  auto stats = externalSort<uint64_t>(dir / "in.bin", dir / "out.bin", options);
+
+  std::sort(values.begin(), values.end());
+  EXPECT_EQ(readRecords<uint64_t>(dir / "out.bin"), values);
+  EXPECT_GT(stats.runs, 1u);
+  EXPECT_GT(stats.mergePasses, 1u);
+  EXPECT_GT(callbacks, stats.runs);
+  // Only the input, the output and the test directory remain.
+  EXPECT_EQ(std::distance(std::filesystem::directory_iterator(dir), {}), 2);
+}
+
+TEST_F(ExternalSortTest, IsStableForRecordsWithComparator) {
+  struct Record {
+    uint32_t key;
+    uint32_t order;
+    bool operator<(const Record& other) const { return key < other.key; }
+  };
+  std::mt19937 gen(4);
+  std::vector<Record> records(20000);
+  for (uint32_t i = 0; i < records.size(); ++i) {
+    records[i] = {static_cast<uint32_t>(gen() % 64), i};
+  }
+  writeRecords(dir / "in.bin", records);
+
+  ExternalSortOptions options;
+  options.memoryBudget = 8 * 1024;
+  options.ioBlockBytes = 1024;
+  options.tempDirectory = dir;
+  externalSort<Record>(dir / "in.bin", dir / "out.bin", options);
+
+  auto sorted = readRecords<Record>(dir / "out.bin");
+  ASSERT_EQ(sorted.size(), records.size());
+  for (size_t i = 1; i < sorted.size(); ++i) {
+    ASSERT_LE(sorted[i - 1].key, sorted[i].key);
+    if (sorted[i - 1].key == sorted[i].key) {
+      EXPECT_LT(sorted[i - 1].order, sorted[i].order);
+    }
+  }
+}
+
+TEST_F(ExternalSortTest, SortsPresortedInputWithSeveralThreads) {
+  // Chunks above kParallelMergeSortThreshold records, so run formation merges
+  // adjacent presorted segments on several threads.
+  std::vector<int64_t> values(200000);
+  for (size_t i = 0; i < values.size(); ++i) values[i] = static_cast<int64_t>(i);
+  writeRecords(dir / "in.bin", values);
+
+  ExternalSortOptions options;
+  options.memoryBudget = 2 * 70000 * sizeof(int64_t);
+  options.tempDirectory = dir;
+  for (size_t threads : {2u, 3u, 4u}) {
+    options.threads = threads;
+    auto stats = externalSort<int64_t>(dir / "in.bin", dir / "out.bin", options);
+    EXPECT_EQ(readRecords<int64_t>(dir / "out.bin"), values) << "threads = " << threads;
+    EXPECT_GT(stats.runs, 1u);
+  }
+}
+
+TEST_F(ExternalSortTest, HandlesEmptyInput) {
+  writeRecords(dir / "in.bin", std::vector<uint32_t>{});
+  externalSort<uint32_t>(dir / "in.bin", dir / "out.bin");
+  EXPECT_EQ(std::filesystem::file_size(dir / "out.bin"), 0u);
+}
+
+TEST_F(ExternalSortTest, RejectsTruncatedRecords) {
+  writeRecords(dir / "in.bin", std::vector<uint8_t>{1, 2, 3});
+  EXPECT_THROW(externalSort<uint32_t>(dir / "in.bin", dir / "out.bin"), std::invalid_argument);
+}
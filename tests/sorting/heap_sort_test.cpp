@@ -2,6 +2,17 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../../src/sorting/sort_observer.hpp"
+
 TEST(HeapSortTest, SortsIntegerArray) {
   std::vector<int> arr = {64, 34, 25, 12, 22, 11, 90};
   std::vector<int> expected = {11, 12, 22, 25, 34, 64, 90};
@@ -27,3 +38,65 @@ TEST(HeapSortTest, HandlesRepeatedElements) {
   heapSort(arr);
   EXPECT_EQ(arr, expected);
 }
+
+TEST(HeapSortTest, SortsSubrangeByProjection) {
+  struct Point {
+    int x;
+    int y;
+  };
+  std::vector<Point> points = {{0, 9}, {1, 4}, {2, 7}, {3, 1}, {4, 0}};
+  heapSort(std::span<Point>{points}.subspan(1, 3), std::ranges::less{}, &Point::y);
+  std::vector<int> xs;
+  for (const Point& p : points) xs.push_back(p.x);
+  EXPECT_EQ(xs, (std::vector<int>{0, 3, 1, 2, 4}));
+}
+
+TEST(HeapSortTest, BottomUpSiftNeedsAboutOneComparisonPerLevel) {
+  std::mt19937 gen(24);
+  std::vector<int> arr(1 << 14);
+  for (auto& x : arr) x = static_cast<int>(gen());
+  SortStats stats;
+  heapSort(arr, CountingSortObserver{stats});
+  EXPECT_TRUE(std::is_sorted(arr.begin(), arr.end()));
+  // A top-down sift takes two comparisons per level, about 2 n log2 n in all.
+  double n = static_cast<double>(arr.size());
+  EXPECT_LT(static_cast<double>(stats.comparisons), 1.2 * n * std::log2(n));
+}
+
+TEST(DAryHeapSortTest, SortsEveryArityAndPartialLastNode) {
+  std::mt19937 gen(25);
+  for (std::size_t n = 0; n < 70; ++n) {
+    std::vector<int> arr(n);
+    for (auto& x : arr) x = static_cast<int>(gen() % 20);
+    auto expected = arr;
+    std::sort(expected.begin(), expected.end());
+    auto two = arr;
+    auto three = arr;
+    auto four = arr;
+    auto eight = arr;
+    dAryHeapSort<2>(two);
+    dAryHeapSort<3>(three);
+    dAryHeapSort<4>(four);
+    dAryHeapSort<8>(eight);
+    EXPECT_EQ(two, expected);
+    EXPECT_EQ(three, expected);
+    EXPECT_EQ(four, expected);
+    EXPECT_EQ(eight, expected);
+  }
+}
+
+TEST(DAryHeapSortTest, SortsLargeInputsByComparatorAndProjection) {
+  std::mt19937 gen(26);
+  std::vector<std::string> words(20000);
+  for (auto& word : words) word = std::to_string(gen() % 100000);
+  auto expected = words;
+  std::sort(expected.begin(), expected.end(), std::greater<>{});
+  dAryHeapSort<4>(words, std::ranges::greater{});
+  EXPECT_EQ(words, expected);
+
+  std::vector<std::pair<int, int>> pairs(50000);
+  for (auto& entry : pairs) entry = {static_cast<int>(gen() % 1000), 0};
+  dAryHeapSort<8>(pairs.begin(), pairs.end(), {}, &std::pair<int, int>::first);
+  EXPECT_TRUE(std::is_sorted(pairs.begin(), pairs.end(),
+                             [](const auto& a, const auto& b) { return a.first < b.first; }));
+}
@@ -0,0 +1,127 @@
+#include "../../src/sorting/incremental_sort.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+std::vector<int> randomInts(std::size_t n, int range, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::vector<int> values(n);
+  for (auto& x : values) x = static_cast<int>(gen() % static_cast<unsigned>(range));
+  return values;
+}
+
+}  // namespace
+
+TEST(IncrementalSortTest, YieldsElementsInSortedOrder) {
+  for (std::size_t n : {0u, 1u, 2u, 31u, 33u, 1000u, 20000u}) {
+    for (int range : {3, 1 << 20}) {
+      auto values = randomInts(n, range, static_cast<unsigned>(n));
+      auto expected = values;
+      std::sort(expected.begin(), expected.end());
+      auto sorter = incrementalSort(values);
+      std::vector<int> yielded;
+      while (!sorter.done()) yielded.push_back(sorter.next());
+      EXPECT_EQ(yielded, expected);
+      EXPECT_EQ(values, expected);
+      EXPECT_THROW(sorter.next(), std::out_of_range);
+    }
+  }
+}
+
+TEST(IncrementalSortTest, SupportsComparatorsAndProjections) {
+  auto values = randomInts(5000, 1000, 1);
+  auto expected = values;
+  std::sort(expected.begin(), expected.end(), std::greater<>{});
+  auto descending = incrementalSort(values.begin(), values.end(), std::ranges::greater{});
+  for (int x : expected) ASSERT_EQ(descending.next(), x);
+
+  std::vector<std::pair<int, std::string>> records;
+  for (int i = 0; i < 300; ++i) records.push_back({(i * 37) % 101, std::to_string(i)});
+  auto byKey = incrementalSort(records, {}, &std::pair<int, std::string>::first);
+  int previous = -1;
+  for (const auto& record : byKey) {
+    EXPECT_LE(previous, record.first);
+    previous = record.first;
+  }
+  EXPECT_TRUE(byKey.done());
+}
+
+TEST(IncrementalSortTest, HandsOutBatches) {
+  auto values = randomInts(10000, 5000, 2);
+  auto expected = values;
+  std::sort(expected.begin(), expected.end());
+  auto sorter = incrementalSort(values);
+  std::size_t offset = 0;
+  for (std::size_t count : {0u, 1u, 7u, 100u, 1000u, 50000u}) {
+    auto batch = sorter.nextBatch(count);
+    auto size = std::min(count, expected.size() - offset);
+    ASSERT_EQ(static_cast<std::size_t>(batch.size()), size);
+    EXPECT_TRUE(std::equal(batch.begin(), batch.end(), expected.begin() + offset));
+    offset += size;
+    EXPECT_EQ(sorter.position(), offset);
+  }
+  EXPECT_TRUE(sorter.done());
+  EXPECT_TRUE(sorter.nextBatch(5).empty());
+}
+
+TEST(IncrementalSortTest, RangeForStopsEarly) {
+  auto values = randomInts(1000, 1 << 20, 3);
+  auto expected = values;
+  std::sort(expected.begin(), expected.end());
+  auto sorter = incrementalSort(values);
+  std::vector<int> smallest;
+  for (int x : sorter) {
+    if (smallest.size() == 10) break;
+    smallest.push_back(x);
+  }
+  EXPECT_EQ(smallest, std::vector<int>(expected.begin(), expected.begin() + 10));
+  // Breaking out leaves the element it looked at for the next read.
+  EXPECT_EQ(sorter.remaining(), 990u);
+  EXPECT_EQ(sorter.peek(), expected[10]);
+}
+
+TEST(IncrementalSortTest, PrefixCostsFarLessThanAFullSort) {
+  auto values = randomInts(1000000, 1 << 30, 4);
+  std::size_t prefixComparisons = 0;
+  auto counting = [&prefixComparisons](int a, int b) {
+    ++prefixComparisons;
+    return a < b;
+  };
+  auto sorter = incrementalSort(values.begin(), values.end(), counting);
+  for (int i = 0; i < 100; ++i) sorter.next();
+  std::size_t afterPrefix = prefixComparisons;
+  while (!sorter.done()) sorter.next();
+  EXPECT_TRUE(std::is_sorted(values.begin(), values.end()));
+  // Selecting the prefix is linear; sorting everything is about n log n.
+  EXPECT_LT(afterPrefix * 5, prefixComparisons);
+  EXPECT_LT(afterPrefix, 5u * values.size());
+}
+
+TEST(IncrementalSortTest, StaysFastOnAdversarialInputs) {
+  std::vector<int> organPipe(200000);
+  for (std::size_t i = 0; i < organPipe.size(); ++i) {
+    organPipe[i] = static_cast<int>(std::min(i, organPipe.size() - i));
+  }
+  std::vector<int> equal(200000, 7);
+  for (auto* values : {&organPipe, &equal}) {
+    std::size_t comparisons = 0;
+    auto counting = [&comparisons](int a, int b) {
+      ++comparisons;
+      return a < b;
+    };
+    auto sorter = incrementalSort(values->begin(), values->end(), counting);
+    while (!sorter.done()) sorter.next();
+    EXPECT_TRUE(std::is_sorted(values->begin(), values->end()));
+    EXPECT_LT(comparisons, 60u * values->size());
+  }
+}
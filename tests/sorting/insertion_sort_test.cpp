@@ -0,0 +1,42 @@
+#include "../../src/sorting/insertion_sort.hpp"
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+TEST(InsertionSortTest, SortsIntegerArray) {
+  std::vector<int> arr = {64, 34, 25, 12, 22, 11, 90};
+  std::vector<int> expected = {11, 12, 22, 25, 34, 64, 90};
+  insertionSort(arr);
+  EXPECT_EQ(arr, expected);
+}
+
+TEST(InsertionSortTest, SortsEmptyArray) {
+  std::vector<int> arr;
+  insertionSort(arr);
+  EXPECT_TRUE(arr.empty());
+}
+
+TEST(InsertionSortTest, SortsSubrangeWithComparator) {
+  std::vector<int> arr = {9, 1, 5, 3, 7, 0};
+  insertionSort(arr.begin() + 1, arr.end() - 1, std::greater<>{});
+  std::vector<int> expected = {9, 7, 5, 3, 1, 0};
+  EXPECT_EQ(arr, expected);
+}
+
+TEST(InsertionSortTest, IsStable) {
+  std::vector<std::pair<int, int>> arr = {{2, 0}, {1, 1}, {2, 2}, {1, 3}, {0, 4}};
+  insertionSort(arr.begin(), arr.end(),
+                [](const auto& a, const auto& b) { return a.first < b.first; });
+  std::vector<std::pair<int, int>> expected = {{0, 4}, {1, 1}, {1, 3}, {2, 0}, {2, 2}};
+  EXPECT_EQ(arr, expected);
+}
+
+TEST(InsertionSortTest, SortsRangeByProjection) {
+  std::vector<std::pair<int, int>> arr = {{2, 0}, {1, 1}, {2, 2}, {1, 3}};
+  insertionSort(arr, std::ranges::less{}, &std::pair<int, int>::first);
+  std::vector<std::pair<int, int>> expected = {{1, 1}, {1, 3}, {2, 0}, {2, 2}};
+  EXPECT_EQ(arr, expected);
+}
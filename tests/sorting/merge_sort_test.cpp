@@ -2,6 +2,17 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <functional>
+#include <memory_resource>
+#include <new>
+#include <numeric>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
 TEST(MergeSortTest, SortsIntegerArray) {
   std::vector<int> arr = {64, 34, 25, 12, 22, 11, 90};
   std::vector<int> expected = {11, 12, 22, 25, 34, 64, 90};
@@ -27,3 +38,156 @@ TEST(MergeSortTest, HandlesRepeatedElements) {
   mergeSort(arr);
   EXPECT_EQ(arr, expected);
 }
+
+TEST(MergeSortTest, SortsLargeRandomArray) {
+  std::mt19937 gen(11);
+  std::vector<int> arr(10007);
+  for (auto& x : arr) x = static_cast<int>(gen() % 1000);
+  std::vector<int> expected = arr;
+  std::sort(expected.begin(), expected.end());
+  mergeSort(arr);
+  EXPECT_EQ(arr, expected);
+}
+
+TEST(MergeSortTest, IsStable) {
+  struct Record {
+    int key;
+    int order;
+    bool operator<(const Record& other) const { return key < other.key; }
+  };
+  std::mt19937 gen(2);
+  std::vector<Record> arr(5000);
+  for (int i = 0; i < static_cast<int>(arr.size()); ++i) {
+    arr[i] = {static_cast<int>(gen() % 16), i};
+  }
+  mergeSort(arr);
+  for (size_t i = 1; i < arr.size(); ++i) {
+    ASSERT_LE(arr[i - 1].key, arr[i].key);
+    if (arr[i - 1].key == arr[i].key) {
+      EXPECT_LT(arr[i - 1].order, arr[i].order);
+    }
+  }
+}
+
+TEST(MergeSortTest, UsesCallerProvidedScratch) {
+  std::vector<int> arr(1000);
+  std::iota(arr.rbegin(), arr.rend(), 0);
+  std::vector<int> scratch(arr.size());
+  mergeSort(arr, std::span<int>{scratch});
+  EXPECT_TRUE(std::is_sorted(arr.begin(), arr.end()));
+
+  std::vector<int> tooSmall(10);
+  EXPECT_THROW(mergeSort(arr, std::span<int>{tooSmall}), std::invalid_argument);
+}
+
+TEST(MergeSortTest, AllocatesScratchFromMemoryResource) {
+  std::vector<int> arr(1000);
+  std::iota(arr.rbegin(), arr.rend(), 0);
+  std::vector<std::byte> arena(arr.size() * sizeof(int));
+  std::pmr::monotonic_buffer_resource resource(arena.data(), arena.size(),
+                                               std::pmr::null_memory_resource());
+  mergeSort(arr, &resource);
+  EXPECT_TRUE(std::is_sorted(arr.begin(), arr.end()));
+
+  std::pmr::monotonic_buffer_resource empty(std::pmr::null_memory_resource());
+  EXPECT_THROW(mergeSort(arr.begin(), arr.end(), &empty, std::ranges::greater{}), std::bad_alloc);
+  std::vector<int> small = {3, 1, 2};
+  mergeSort(small, &empty);
+  EXPECT_EQ(small, (std::vector<int>{1, 2, 3}));
+}
+
+TEST(MergeSortTest, MergesAdjacentRuns) {
+  std::vector<int> arr = {1, 4, 9, 2, 3, 10};
+  std::vector<int> scratch(3);
+  merge(std::span<int>{arr}, 0, 2, 5, std::span<int>{scratch});
+  std::vector<int> expected = {1, 2, 3, 4, 9, 10};
+  EXPECT_EQ(arr, expected);
+}
+
+TEST(MergeSortTest, SortsByProjectionStably) {
+  struct Order {
+    int customer;
+    int id;
+  };
+  std::mt19937 gen(4);
+  std::vector<Order> orders(3000);
+  for (int i = 0; i < static_cast<int>(orders.size()); ++i) {
+    orders[i] = {static_cast<int>(gen() % 50), i};
+  }
+  mergeSort(orders, std::ranges::less{}, &Order::customer);
+  for (size_t i = 1; i < orders.size(); ++i) {
+    ASSERT_LE(orders[i - 1].customer, orders[i].customer);
+    if (orders[i - 1].customer == orders[i].customer) {
+      EXPECT_LT(orders[i - 1].id, orders[i].id);
+    }
+  }
+}
+
+TEST(MergeSortTest, SortsSliceInPlace) {
+  std::vector<int> arr(200);
+  std::iota(arr.rbegin(), arr.rend(), 0);
+  mergeSort(std::span<int>{arr}.subspan(50, 100));
+  EXPECT_TRUE(std::is_sorted(arr.begin() + 50, arr.begin() + 150));
+  EXPECT_EQ(arr[49], 150);
+  EXPECT_EQ(arr[150], 49);
+}
+
+TEST(ParallelMergeSortTest, MatchesSequentialResult) {
+  std::mt19937 gen(21);
+  std::vector<int> arr(200003);
+  for (auto& x : arr) x = static_cast<int>(gen());
+  std::vector<int> expected = arr;
+  std::sort(expected.begin(), expected.end());
+  parallelMergeSort(arr, 4);
+  EXPECT_EQ(arr, expected);
+
+  std::vector<int> reversed(expected.rbegin(), expected.rend());
+  parallelMergeSort(reversed, 3);
+  EXPECT_EQ(reversed, expected);
+}
+
+template <typename T>
+void expectParallelMergeSortsPresorted() {
+  for (std::size_t n : {std::size_t{65536}, std::size_t{70000}, std::size_t{100000}}) {
+    std::vector<T> expected(n);
+    std::iota(expected.begin(), expected.end(), T{0});
+    for (std::size_t threads : {2u, 3u, 4u}) {
+      std::vector<T> sorted = expected;
+      parallelMergeSort(sorted, threads);
+      EXPECT_EQ(sorted, expected) << "n = " << n << ", threads = " << threads;
+      std::vector<T> reversed(expected.rbegin(), expected.rend());
+      parallelMergeSort(reversed, threads);
+      EXPECT_EQ(reversed, expected) << "n = " << n << ", threads = " << threads;
+    }
+  }
+}
+
+TEST(ParallelMergeSortTest, SortsPresortedAndReversedInts) {
+  expectParallelMergeSortsPresorted<int>();
+}
+
+TEST(ParallelMergeSortTest, SortsPresortedAndReversedLongs) {
+  expectParallelMergeSortsPresorted<long>();
+}
+
+TEST(ParallelMergeSortTest, IsStable) {
+  std::mt19937 gen(8);
+  std::vector<std::pair<int, int>> arr(100000);
+  for (int i = 0; i < static_cast<int>(arr.size()); ++i) {
+    arr[i] = {static_cast<int>(gen() % 32), i};
+  }
+  std::vector<std::pair<int, int>> scratch(arr.size());
+  parallelMergeSort(arr.begin(), arr.end(), scratch.begin(),
+                    [](const auto& a, const auto& b) { return a.first < b.first; }, 5);
+  EXPECT_TRUE(std::is_sorted(arr.begin(), arr.end()));
+}
+
+TEST(ParallelMergeSortTest, SortsByProjectionStably) {
+  std::mt19937 gen(12);
+  std::vector<std::pair<int, int>> arr(100000);
+  for (int i = 0; i < static_cast<int>(arr.size()); ++i) {
+    arr[i] = {static_cast<int>(gen() % 32), i};
+  }
+  parallelMergeSort(arr, std::ranges::less{}, &std::pair<int, int>::first, 4);
+  EXPECT_TRUE(std::ranges::is_sorted(arr));
+}
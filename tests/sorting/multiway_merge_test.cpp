@@ -0,0 +1,158 @@
+#include "../../src/sorting/multiway_merge.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <span>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+std::vector<std::vector<int>> makeRuns(std::size_t k, std::size_t maxLength, int range,
+                                       unsigned seed) {
+  std::mt19937 gen(seed);
+  std::vector<std::vector<int>> runs(k);
+  for (auto& run : runs) {
+    run.resize(gen() % (maxLength + 1));
+    for (auto& x : run) x = static_cast<int>(gen() % static_cast<unsigned>(range));
+    std::sort(run.begin(), run.end());
+  }
+  return runs;
+}
+
+std::vector<int> concatenated(const std::vector<std::vector<int>>& runs) {
+  std::vector<int> all;
+  for (const auto& run : runs) all.insert(all.end(), run.begin(), run.end());
+  return all;
+}
+
+}  // namespace
+
+TEST(MultiwayMergeTest, MergesVectorRuns) {
+  for (std::size_t k : {0u, 1u, 2u, 3u, 7u, 64u, 300u}) {
+    auto runs = makeRuns(k, 200, 1000, static_cast<unsigned>(k));
+    auto expected = concatenated(runs);
+    std::sort(expected.begin(), expected.end());
+    std::vector<int> merged;
+    multiwayMerge(runs, std::back_inserter(merged));
+    EXPECT_EQ(merged, expected);
+  }
+}
+
+TEST(MultiwayMergeTest, KeepsRunOrderForEqualKeys) {
+  using Entry = std::pair<int, int>;
+  std::vector<std::vector<Entry>> runs(5);
+  std::mt19937 gen(2);
+  for (int r = 0; r < 5; ++r) {
+    for (int i = 0; i < 100; ++i) runs[r].push_back({static_cast<int>(gen() % 10), r * 1000 + i});
+    std::stable_sort(runs[r].begin(), runs[r].end(),
+                     [](const Entry& a, const Entry& b) { return a.first < b.first; });
+  }
+  std::vector<Entry> expected;
+  for (const auto& run : runs) expected.insert(expected.end(), run.begin(), run.end());
+  std::stable_sort(expected.begin(), expected.end(),
+                   [](const Entry& a, const Entry& b) { return a.first < b.first; });
+  std::vector<Entry> merged(expected.size());
+  auto end = multiwayMerge(runs, merged.begin(), {}, &Entry::first);
+  EXPECT_EQ(end, merged.end());
+  EXPECT_EQ(merged, expected);
+}
+
+TEST(MultiwayMergeTest, MergesStreamsListsAndDescendingRuns) {
+  std::istringstream a("1 4 9 12");
+  std::istringstream b("2 3 10");
+  std::istringstream c("");
+  std::vector<std::ranges::istream_view<int>> streams = {
+      std::views::istream<int>(a), std::views::istream<int>(b), std::views::istream<int>(c)};
+  std::vector<int> merged;
+  multiwayMerge(streams, std::back_inserter(merged));
+  EXPECT_EQ(merged, (std::vector<int>{1, 2, 3, 4, 9, 10, 12}));
+
+  std::vector<std::list<int>> lists = {{9, 5, 1}, {8, 2}, {7, 6, 3}};
+  std::vector<int> descending;
+  multiwayMerge(lists, std::back_inserter(descending), std::ranges::greater{});
+  EXPECT_EQ(descending, (std::vector<int>{9, 8, 7, 6, 5, 3, 2, 1}));
+}
+
+TEST(MultiwayMergeTest, ComparesOnlyRealHeadsOfPointerRuns) {
+  // Three runs leave a padding leaf, which must never reach strcmp.
+  std::vector<std::vector<const char*>> runs = {{"apple", "fig"}, {}, {"banana", "cherry"}};
+  std::vector<const char*> merged;
+  multiwayMerge(runs, std::back_inserter(merged),
+                [](const char* a, const char* b) { return std::strcmp(a, b) < 0; });
+  std::vector<std::string> words(merged.begin(), merged.end());
+  EXPECT_EQ(words, (std::vector<std::string>{"apple", "banana", "cherry", "fig"}));
+}
+
+TEST(MultiwayMergeTest, MergesValuesWithoutDefaultConstructor) {
+  struct Key {
+    explicit Key(int v) : value(v) {}
+    int value;
+  };
+  std::vector<std::vector<Key>> runs(3);
+  for (int i = 0; i < 30; ++i) runs[i % 3].emplace_back(i);
+  std::vector<Key> merged;
+  multiwayMerge(runs, std::back_inserter(merged), {}, &Key::value);
+  ASSERT_EQ(merged.size(), 30u);
+  for (int i = 0; i < 30; ++i) EXPECT_EQ(merged[i].value, i);
+}
+
+TEST(MultiwayMergeTest, SplitTakesExactlyTheFirstRankOutputs) {
+  auto runs = makeRuns(17, 400, 50, 4);
+  std::vector<std::pair<std::vector<int>::const_iterator, std::vector<int>::const_iterator>>
+      bounds;
+  for (const auto& run : runs) bounds.emplace_back(run.cbegin(), run.cend());
+  auto expected = concatenated(runs);
+  std::sort(expected.begin(), expected.end());
+  auto n = static_cast<std::ptrdiff_t>(expected.size());
+  for (std::ptrdiff_t rank : {std::ptrdiff_t{0}, std::ptrdiff_t{1}, n / 3, n / 2, n - 1, n}) {
+    auto counts = multiwayMergeSplit(bounds, rank, std::less<>{});
+    EXPECT_EQ(std::accumulate(counts.begin(), counts.end(), std::ptrdiff_t{0}), rank);
+    for (std::size_t i = 0; i < runs.size(); ++i) {
+      // Everything taken precedes everything left, ties going to earlier runs.
+      for (std::size_t j = 0; j < runs.size(); ++j) {
+        if (counts[i] == 0 || counts[j] == static_cast<std::ptrdiff_t>(runs[j].size())) continue;
+        int taken = runs[i][counts[i] - 1];
+        int left = runs[j][counts[j]];
+        EXPECT_TRUE(taken < left || (taken == left && i <= j));
+      }
+    }
+  }
+}
+
+TEST(ParallelMultiwayMergeTest, MatchesSequentialMerge) {
+  auto runs = makeRuns(40, 20000, 300, 5);
+  runs.push_back({});
+  std::vector<std::span<const int>> spans(runs.begin(), runs.end());
+  std::vector<int> expected;
+  multiwayMerge(spans, std::back_inserter(expected));
+  for (std::size_t threads : {2u, 3u, 8u}) {
+    std::vector<int> merged(expected.size());
+    auto end = parallelMultiwayMerge(spans, merged.begin(), {}, {}, threads);
+    EXPECT_EQ(end, merged.end());
+    EXPECT_EQ(merged, expected);
+  }
+}
+
+TEST(ParallelMultiwayMergeTest, KeepsRunOrderAcrossThreadSlices) {
+  using Entry = std::pair<int, int>;
+  std::vector<std::vector<Entry>> runs(6);
+  for (int r = 0; r < 6; ++r) {
+    for (int i = 0; i < 30000; ++i) runs[r].push_back({i / 5000, r * 100000 + i});
+  }
+  std::vector<Entry> expected;
+  multiwayMerge(runs, std::back_inserter(expected), {}, &Entry::first);
+  std::vector<Entry> merged(expected.size());
+  parallelMultiwayMerge(runs, merged.begin(), {}, &Entry::first, 4);
+  EXPECT_EQ(merged, expected);
+}
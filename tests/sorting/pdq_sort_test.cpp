@@ -0,0 +1,81 @@
+#include "../../src/sorting/pdq_sort.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../../src/sorting/sort_observer.hpp"
+
+TEST(PdqSortTest, SortsIntegerArray) {
+  std::vector<int> arr = {64, 34, 25, 12, 22, 11, 90};
+  std::vector<int> expected = {11, 12, 22, 25, 34, 64, 90};
+  pdqSort(arr);
+  EXPECT_EQ(arr, expected);
+}
+
+TEST(PdqSortTest, SortsEmptyAndSingleElementArrays) {
+  std::vector<int> empty;
+  pdqSort(empty);
+  EXPECT_TRUE(empty.empty());
+  std::vector<int> single = {1};
+  pdqSort(single);
+  EXPECT_EQ(single, std::vector<int>{1});
+}
+
+TEST(PdqSortTest, MatchesStdSortOnPatterns) {
+  std::mt19937 gen(31);
+  const std::size_t n = 100000;
+  std::vector<std::vector<int>> inputs(5, std::vector<int>(n));
+  for (std::size_t i = 0; i < n; ++i) {
+    inputs[0][i] = static_cast<int>(gen());
+    inputs[1][i] = static_cast<int>(n - i);
+    inputs[2][i] = static_cast<int>(gen() % 4);
+    inputs[3][i] = static_cast<int>(i < n / 2 ? i : n - i);
+    inputs[4][i] = static_cast<int>(i % 2 == 0 ? i : n - i);
+  }
+  for (auto& arr : inputs) {
+    std::vector<int> expected = arr;
+    std::ranges::sort(expected);
+    pdqSort(arr);
+    EXPECT_EQ(arr, expected);
+  }
+}
+
+TEST(PdqSortTest, SortedAndEqualInputsTakeLinearComparisons) {
+  std::vector<int> sorted(100000);
+  std::iota(sorted.begin(), sorted.end(), 0);
+  SortStats sortedStats;
+  pdqSort(sorted, CountingSortObserver{sortedStats});
+  EXPECT_TRUE(std::ranges::is_sorted(sorted));
+  EXPECT_LT(sortedStats.comparisons, 3 * sorted.size());
+
+  std::vector<int> equal(100000, 7);
+  SortStats equalStats;
+  pdqSort(equal, CountingSortObserver{equalStats});
+  EXPECT_LT(equalStats.comparisons, 3 * equal.size());
+}
+
+TEST(PdqSortTest, SortsNonArithmeticKeysWithProjection) {
+  std::mt19937 gen(32);
+  std::vector<std::pair<std::string, int>> arr(5000);
+  for (auto& [name, score] : arr) {
+    score = static_cast<int>(gen() % 100);
+    name = std::to_string(gen());
+  }
+  pdqSort(arr, std::ranges::greater{}, &std::pair<std::string, int>::second);
+  EXPECT_TRUE(
+      std::ranges::is_sorted(arr, std::ranges::greater{}, &std::pair<std::string, int>::second));
+}
+
+TEST(PdqSortTest, SortsSliceWithComparator) {
+  std::vector<double> arr = {9.0, 1.0, 3.0, 2.0, 0.0};
+  pdqSort(std::span<double>{arr}.subspan(1, 3), std::ranges::greater{});
+  EXPECT_EQ(arr, (std::vector<double>{9.0, 3.0, 2.0, 1.0, 0.0}));
+}
@@ -0,0 +1,100 @@
+#include "../../src/sorting/power_sort.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../../src/sorting/sort_observer.hpp"
+
+TEST(PowerSortTest, SortsIntegerArray) {
+  std::vector<int> arr = {64, 34, 25, 12, 22, 11, 90};
+  std::vector<int> expected = {11, 12, 22, 25, 34, 64, 90};
+  powerSort(arr);
+  EXPECT_EQ(arr, expected);
+}
+
+TEST(PowerSortTest, SortsEmptyAndSingleElementArrays) {
+  std::vector<int> empty;
+  powerSort(empty);
+  EXPECT_TRUE(empty.empty());
+  std::vector<int> single = {1};
+  powerSort(single);
+  EXPECT_EQ(single, std::vector<int>{1});
+}
+
+TEST(PowerSortTest, MatchesStdSortOnRandomInput) {
+  std::mt19937 gen(21);
+  for (std::size_t n : {2u, 31u, 33u, 100u, 1000u, 54321u}) {
+    std::vector<int> arr(n);
+    for (auto& x : arr) x = static_cast<int>(gen() % 1000);
+    std::vector<int> expected = arr;
+    std::ranges::sort(expected);
+    powerSort(arr);
+    EXPECT_EQ(arr, expected) << "n = " << n;
+  }
+}
+
+TEST(PowerSortTest, IsStable) {
+  std::mt19937 gen(22);
+  std::vector<std::pair<int, int>> arr(20000);
+  for (int i = 0; i < static_cast<int>(arr.size()); ++i) {
+    arr[i] = {static_cast<int>(gen() % 16), i};
+  }
+  // Plant equal keys inside descending stretches as well.
+  std::sort(arr.begin(), arr.begin() + 5000,
+            [](const auto& a, const auto& b) { return a.first > b.first; });
+  powerSort(arr, std::ranges::less{}, &std::pair<int, int>::first);
+  for (std::size_t i = 1; i < arr.size(); ++i) {
+    ASSERT_LE(arr[i - 1].first, arr[i].first);
+    if (arr[i - 1].first == arr[i].first && i >= 5000) {
+      // Elements from the shuffled part keep their relative order.
+      if (arr[i - 1].second >= 5000 && arr[i].second >= 5000) {
+        EXPECT_LT(arr[i - 1].second, arr[i].second);
+      }
+    }
+  }
+}
+
+TEST(PowerSortTest, SortedAndReversedInputsTakeLinearComparisons) {
+  std::vector<int> arr(100000);
+  std::iota(arr.begin(), arr.end(), 0);
+  SortStats sorted;
+  powerSort(arr, CountingSortObserver{sorted});
+  EXPECT_EQ(sorted.comparisons, arr.size() - 1);
+
+  std::ranges::reverse(arr);
+  SortStats reversed;
+  powerSort(arr, CountingSortObserver{reversed});
+  EXPECT_TRUE(std::ranges::is_sorted(arr));
+  EXPECT_EQ(reversed.comparisons, arr.size() - 1);
+}
+
+TEST(PowerSortTest, NearlySortedInputIsCheap) {
+  std::mt19937 gen(23);
+  std::vector<int> arr(100000);
+  std::iota(arr.begin(), arr.end(), 0);
+  // Late arrivals: 1% of the records are displaced towards the end.
+  for (int k = 0; k < 1000; ++k) {
+    std::size_t from = gen() % arr.size();
+    std::size_t to = std::min(arr.size() - 1, from + gen() % 5000);
+    std::rotate(arr.begin() + from, arr.begin() + from + 1, arr.begin() + to + 1);
+  }
+  SortStats stats;
+  powerSort(arr, CountingSortObserver{stats});
+  EXPECT_TRUE(std::ranges::is_sorted(arr));
+  // A full merge sort needs about n log2 n = 1.7 million comparisons.
+  EXPECT_LT(stats.comparisons, 5 * arr.size());
+}
+
+TEST(PowerSortTest, SortsSliceWithComparator) {
+  std::vector<std::string> arr = {"z", "b", "d", "c", "a"};
+  powerSort(std::span<std::string>{arr}.subspan(1, 3), std::ranges::greater{});
+  EXPECT_EQ(arr, (std::vector<std::string>{"z", "d", "c", "b", "a"}));
+}
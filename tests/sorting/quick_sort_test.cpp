@@ -2,6 +2,16 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
 TEST(QuickSortTest, SortsIntegerArray) {
   std::vector<int> arr = {64, 34, 25, 12, 22, 11, 90};
   std::vector<int> expected = {11, 12, 22, 25, 34, 64, 90};
@@ -27,3 +37,93 @@ TEST(QuickSortTest, HandlesRepeatedElements) {
   quickSort(arr);
   EXPECT_EQ(arr, expected);
 }
+
+TEST(QuickSortTest, SortsSortedAndReversedInputs) {
+  std::vector<int> arr(100000);
+  std::iota(arr.begin(), arr.end(), 0);
+  std::vector<int> expected = arr;
+  quickSort(arr);
+  EXPECT_EQ(arr, expected);
+
+  std::reverse(arr.begin(), arr.end());
+  quickSort(arr);
+  EXPECT_EQ(arr, expected);
+}
+
+TEST(QuickSortTest, SortsRandomInputWithDuplicates) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> dist(0, 50);
+  std::vector<int> arr(50000);
+  for (auto& x : arr) x = dist(gen);
+  std::vector<int> expected = arr;
+  std::sort(expected.begin(), expected.end());
+  quickSort(arr);
+  EXPECT_EQ(arr, expected);
+}
+
+TEST(QuickSortTest, SortsWithCustomComparator) {
+  std::vector<int> arr = {3, 1, 4, 1, 5, 9, 2, 6};
+  quickSort(arr.begin(), arr.end(), std::greater<>{});
+  std::vector<int> expected = {9, 6, 5, 4, 3, 2, 1, 1};
+  EXPECT_EQ(arr, expected);
+}
+
+TEST(QuickSortTest, SortsRecordsByProjection) {
+  struct Employee {
+    std::string name;
+    int salary;
+  };
+  std::vector<Employee> staff;
+  std::mt19937 gen(11);
+  for (int i = 0; i < 500; ++i) {
+    staff.push_back({"e" + std::to_string(i), static_cast<int>(gen() % 100000)});
+  }
+  quickSort(staff, std::ranges::greater{}, &Employee::salary);
+  EXPECT_TRUE(std::ranges::is_sorted(staff, std::ranges::greater{}, &Employee::salary));
+}
+
+TEST(QuickSortTest, SortsSliceInPlace) {
+  std::array<int, 8> arr = {8, 7, 6, 5, 4, 3, 2, 1};
+  quickSort(std::span<int>{arr}.subspan(2, 4));
+  EXPECT_EQ(arr, (std::array<int, 8>{8, 7, 3, 4, 5, 6, 2, 1}));
+}
+
+TEST(QuickSortTest, PartitionPlacesPivot) {
+  std::vector<int> arr = {7, 2, 9, 4, 5};
+  size_t pi = partition(arr, 0, arr.size() - 1);
+  EXPECT_EQ(arr[pi], 5);
+  for (size_t i = 0; i < pi; ++i) EXPECT_LE(arr[i], 5);
+  for (size_t i = pi + 1; i < arr.size(); ++i) EXPECT_GE(arr[i], 5);
+}
+
+TEST(ParallelQuickSortTest, MatchesSequentialResult) {
+  std::mt19937 gen(7);
+  std::vector<int> arr(300000);
+  for (auto& x : arr) x = static_cast<int>(gen());
+  std::vector<int> expected = arr;
+  std::sort(expected.begin(), expected.end());
+  parallelQuickSort(arr, 4);
+  EXPECT_EQ(arr, expected);
+}
+
+TEST(ParallelQuickSortTest, HandlesFewUniqueAndSortedInputs) {
+  std::vector<int> arr(300000);
+  for (size_t i = 0; i < arr.size(); ++i) arr[i] = static_cast<int>(i % 3);
+  std::vector<int> expected = arr;
+  std::sort(expected.begin(), expected.end());
+  parallelQuickSort(arr, 4);
+  EXPECT_EQ(arr, expected);
+
+  parallelQuickSort(arr, 3);
+  EXPECT_EQ(arr, expected);
+}
+
+TEST(ParallelQuickSortTest, SortsByProjection) {
+  std::mt19937 gen(9);
+  std::vector<std::pair<int, int>> arr(200000);
+  for (int i = 0; i < static_cast<int>(arr.size()); ++i) {
+    arr[i] = {static_cast<int>(gen() % 1000), i};
+  }
+  parallelQuickSort(arr, std::ranges::greater{}, &std::pair<int, int>::first, 4);
+  EXPECT_TRUE(std::ranges::is_sorted(arr, std::ranges::greater{}, &std::pair<int, int>::first));
+}
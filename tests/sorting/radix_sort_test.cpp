@@ -2,6 +2,19 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "../../src/sorting/sort_observer.hpp"
+
 TEST(RadixSortTest, SortsPositiveIntegers) {
   std::vector<int> arr = {170, 45, 75, 90, 802, 24, 2, 66};
   std::vector<int> expected = {2, 24, 45, 66, 75, 90, 170, 802};
@@ -21,3 +34,249 @@ TEST(RadixSortTest, HandlesSingleDigitNumbers) {
   radixSort(arr);
   EXPECT_EQ(arr, expected);
 }
+
+TEST(RadixSortTest, HandlesNegativeIntegers) {
+  std::vector<int> arr = {5, -3, 0, -100, 42, -1, 7, std::numeric_limits<int>::min(),
+                          std::numeric_limits<int>::max()};
+  std::vector<int> expected = arr;
+  std::sort(expected.begin(), expected.end());
+  radixSort(arr);
+  EXPECT_EQ(arr, expected);
+}
+
+TEST(RadixSortTest, SortsLargeUnsigned64BitKeys) {
+  std::mt19937_64 gen(123);
+  std::vector<uint64_t> arr(10000);
+  for (auto& x : arr) x = gen();
+  std::vector<uint64_t> expected = arr;
+  std::sort(expected.begin(), expected.end());
+  radixSort(arr);
+  EXPECT_EQ(arr, expected);
+}
+
+TEST(RadixSortTest, SortsSignedKeysSharingHighBytes) {
+  std::mt19937 gen(5);
+  std::uniform_int_distribution<int64_t> dist(-1000, 1000);
+  std::vector<int64_t> arr(5000);
+  for (auto& x : arr) x = dist(gen);
+  std::vector<int64_t> expected = arr;
+  std::sort(expected.begin(), expected.end());
+  radixSort(arr);
+  EXPECT_EQ(arr, expected);
+}
+
+TEST(RadixSortTest, SortsFloatingPointValues) {
+  std::mt19937 gen(9);
+  std::uniform_real_distribution<double> dist(-1e6, 1e6);
+  std::vector<double> doubles(3000);
+  for (auto& x : doubles) x = dist(gen);
+  doubles.push_back(-std::numeric_limits<double>::infinity());
+  doubles.push_back(std::numeric_limits<double>::infinity());
+  std::vector<double> expectedDoubles = doubles;
+  std::sort(expectedDoubles.begin(), expectedDoubles.end());
+  radixSort(doubles);
+  EXPECT_EQ(doubles, expectedDoubles);
+
+  std::vector<float> floats = {3.5f, -0.25f, 0.0f, -7.0f, 1e-30f, -1e30f, 2.0f};
+  std::vector<float> expectedFloats = floats;
+  std::sort(expectedFloats.begin(), expectedFloats.end());
+  radixSort(floats);
+  EXPECT_EQ(floats, expectedFloats);
+}
+
+TEST(RadixSortTest, RejectsUndersizedBuffer) {
+  std::vector<int> arr(1000, 1);
+  std::vector<int> buffer(10);
+  EXPECT_THROW(radixSort(std::span<int>{arr}, std::span<int>{buffer}), std::invalid_argument);
+}
+
+TEST(RadixSortTest, AllocatesBufferFromMemoryResource) {
+  std::mt19937 gen(12);
+  std::vector<uint32_t> arr(2000);
+  for (auto& x : arr) x = static_cast<uint32_t>(gen());
+  std::vector<std::byte> arena(arr.size() * sizeof(uint32_t));
+  std::pmr::monotonic_buffer_resource resource(arena.data(), arena.size(),
+                                               std::pmr::null_memory_resource());
+  radixSort(arr, &resource);
+  EXPECT_TRUE(std::is_sorted(arr.begin(), arr.end()));
+
+  std::pmr::monotonic_buffer_resource empty(std::pmr::null_memory_resource());
+  EXPECT_THROW(radixSort(std::span<uint32_t>{arr}, &empty), std::bad_alloc);
+}
+
+TEST(RadixSortTest, SortsSliceInPlace) {
+  std::vector<int32_t> arr(1000);
+  for (size_t i = 0; i < arr.size(); ++i) arr[i] = static_cast<int32_t>(arr.size() - i);
+  radixSort(std::span<int32_t>{arr}.subspan(100, 800));
+  EXPECT_TRUE(std::is_sorted(arr.begin() + 100, arr.begin() + 900));
+  EXPECT_EQ(arr[99], 901);
+  EXPECT_EQ(arr[900], 100);
+}
+
+TEST(RadixSortByTest, SortsSmallAndLargeRecordsStably) {
+  struct Event {
+    uint32_t timestamp;
+    uint32_t id;
+  };
+  struct WideEvent {
+    uint64_t timestamp;
+    uint64_t id;
+    double payload[2];
+  };
+  std::mt19937 gen(90);
+  std::vector<Event> events(5000);
+  std::vector<WideEvent> wide(5000);
+  for (uint32_t i = 0; i < events.size(); ++i) {
+    events[i] = {static_cast<uint32_t>(gen() % 300), i};
+    wide[i] = {gen() % 300, i, {0.5 * i, 0.0}};
+  }
+  std::vector<Event> expected = events;
+  std::stable_sort(expected.begin(), expected.end(),
+                   [](const Event& a, const Event& b) { return a.timestamp < b.timestamp; });
+  radixSortBy(events, &Event::timestamp);
+  radixSortBy(std::span<WideEvent>{wide}, &WideEvent::timestamp);
+  for (std::size_t i = 0; i < events.size(); ++i) {
+    EXPECT_EQ(events[i].id, expected[i].id);
+    EXPECT_EQ(events[i].timestamp, expected[i].timestamp);
+    if (i > 0) {
+      EXPECT_LE(wide[i - 1].timestamp, wide[i].timestamp);
+      if (wide[i - 1].timestamp == wide[i].timestamp) {
+        EXPECT_LT(wide[i - 1].id, wide[i].id);
+      }
+    }
+    EXPECT_EQ(wide[i].payload[0], 0.5 * static_cast<double>(wide[i].id));
+  }
+}
+
+TEST(RadixSortByTest, AllocatesScratchFromMemoryResource) {
+  struct WideEvent {
+    uint64_t timestamp;
+    uint64_t id;
+    double payload[2];
+  };
+  std::mt19937 gen(92);
+  std::vector<WideEvent> wide(4000);
+  for (uint64_t i = 0; i < wide.size(); ++i) wide[i] = {gen() % 100, i, {0.0, 0.0}};
+  std::pmr::unsynchronized_pool_resource pool;
+  radixSortBy(std::span<WideEvent>{wide}, &pool, &WideEvent::timestamp);
+  for (std::size_t i = 1; i < wide.size(); ++i) {
+    ASSERT_LE(wide[i - 1].timestamp, wide[i].timestamp);
+    if (wide[i - 1].timestamp == wide[i].timestamp) {
+      EXPECT_LT(wide[i - 1].id, wide[i].id);
+    }
+  }
+
+  std::pmr::monotonic_buffer_resource empty(std::pmr::null_memory_resource());
+  EXPECT_THROW(radixSortBy(std::span<WideEvent>{wide}, &empty, &WideEvent::id), std::bad_alloc);
+}
+
+TEST(RadixSortByTest, SortsMoveOnlyRecordsThroughIndices) {
+  struct Job {
+    explicit Job(int64_t priority) : priority(priority), name(std::make_unique<int>(-priority)) {}
+    int64_t priority;
+    std::unique_ptr<int> name;
+  };
+  std::mt19937 gen(91);
+  std::vector<Job> jobs;
+  for (int i = 0; i < 3000; ++i) jobs.emplace_back(static_cast<int64_t>(gen() % 2001) - 1000);
+  SortStats stats;
+  radixSortBy(jobs, [](const Job& job) { return job.priority; }, CountingSortObserver{stats});
+  for (std::size_t i = 0; i < jobs.size(); ++i) {
+    EXPECT_EQ(*jobs[i].name, -jobs[i].priority);
+    if (i > 0) {
+      EXPECT_LE(jobs[i - 1].priority, jobs[i].priority);
+    }
+  }
+  EXPECT_GT(stats.allocatedBytes, 0u);
+}
+
+TEST(ParallelRadixSortTest, MatchesSequentialResult) {
+  std::mt19937_64 gen(77);
+  std::vector<uint64_t> arr(200000);
+  for (auto& x : arr) x = gen();
+  std::vector<uint64_t> expected = arr;
+  std::sort(expected.begin(), expected.end());
+  parallelRadixSort(arr, 4);
+  EXPECT_EQ(arr, expected);
+}
+
+TEST(ParallelRadixSortTest, HandlesSignedAndFloatingKeys) {
+  std::mt19937 gen(3);
+  std::uniform_int_distribution<int32_t> intDist(-5000, 5000);
+  std::vector<int32_t> ints(150000);
+  for (auto& x : ints) x = intDist(gen);
+  std::vector<int32_t> expectedInts = ints;
+  std::sort(expectedInts.begin(), expectedInts.end());
+  parallelRadixSort(ints, 3);
+  EXPECT_EQ(ints, expectedInts);
+
+  std::normal_distribution<float> floatDist(0.0f, 100.0f);
+  std::vector<float> floats(150000);
+  for (auto& x : floats) x = floatDist(gen);
+  std::vector<float> expectedFloats = floats;
+  std::sort(expectedFloats.begin(), expectedFloats.end());
+  parallelRadixSort(floats, 5);
+  EXPECT_EQ(floats, expectedFloats);
+}
+
+TEST(AmericanFlagSortTest, MatchesStdSort) {
+  std::mt19937_64 gen(78);
+  std::vector<uint64_t> arr(100000);
+  for (auto& x : arr) x = gen();
+  std::vector<uint64_t> expected = arr;
+  std::sort(expected.begin(), expected.end());
+  americanFlagSort(arr);
+  EXPECT_EQ(arr, expected);
+}
+
+TEST(AmericanFlagSortTest, HandlesSharedPrefixesAndDuplicates) {
+  std::mt19937_64 gen(79);
+  std::vector<uint64_t> ids(50000);
+  for (auto& x : ids) x = 0xC1A7000000000000ull | (gen() % 3000);
+  std::vector<uint64_t> expected = ids;
+  std::sort(expected.begin(), expected.end());
+  americanFlagSort(ids);
+  EXPECT_EQ(ids, expected);
+
+  std::vector<int32_t> ints(50000);
+  for (auto& x : ints) x = static_cast<int32_t>(gen() % 200) - 100;
+  std::vector<int32_t> expectedInts = ints;
+  std::sort(expectedInts.begin(), expectedInts.end());
+  americanFlagSort(ints);
+  EXPECT_EQ(ints, expectedInts);
+}
+
+TEST(AmericanFlagSortTest, SortsRecordsByKeyWithoutScratch) {
+  struct Row {
+    double score;
+    int id;
+  };
+  std::mt19937 gen(80);
+  std::normal_distribution<double> dist(0.0, 1000.0);
+  std::vector<Row> rows(20000);
+  for (int i = 0; i < static_cast<int>(rows.size()); ++i) rows[i] = {dist(gen), i};
+  SortStats stats;
+  americanFlagSortBy(std::span<Row>{rows}, &Row::score, CountingSortObserver{stats});
+  EXPECT_TRUE(std::is_sorted(rows.begin(), rows.end(),
+                             [](const Row& a, const Row& b) { return a.score < b.score; }));
+  EXPECT_EQ(stats.allocatedBytes, 0u);
+}
+
+TEST(ParallelAmericanFlagSortTest, MatchesStdSort) {
+  std::mt19937_64 gen(81);
+  for (std::size_t threads : {2u, 4u}) {
+    std::vector<uint64_t> arr(300000);
+    for (auto& x : arr) x = gen() >> 20;
+    std::vector<uint64_t> expected = arr;
+    std::sort(expected.begin(), expected.end());
+    parallelAmericanFlagSort(arr, threads);
+    EXPECT_EQ(arr, expected);
+  }
+  std::vector<float> floats(200000);
+  std::normal_distribution<float> dist(0.0f, 10.0f);
+  for (auto& x : floats) x = dist(gen);
+  std::vector<float> expected = floats;
+  std::sort(expected.begin(), expected.end());
+  parallelAmericanFlagSort(floats, 3);
+  EXPECT_EQ(floats, expected);
+}
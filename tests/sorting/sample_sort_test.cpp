@@ -0,0 +1,124 @@
+#include "../../src/sorting/sample_sort.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../../src/sorting/sort_observer.hpp"
+
+namespace {
+
+std::vector<int> patternInts(std::size_t n, int pattern) {
+  std::mt19937 gen(41);
+  std::vector<int> arr(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    switch (pattern) {
+      case 0:
+        arr[i] = static_cast<int>(gen());
+        break;
+      case 1:
+        arr[i] = static_cast<int>(gen() % 3);
+        break;
+      case 2:
+        arr[i] = static_cast<int>(n - i);
+        break;
+      default:
+        arr[i] = static_cast<int>(i < n / 2 ? i : n - i);
+        break;
+    }
+  }
+  return arr;
+}
+
+}  // namespace
+
+TEST(SampleSortTest, SortsIntegerArray) {
+  std::vector<int> arr = {64, 34, 25, 12, 22, 11, 90};
+  sampleSort(arr);
+  EXPECT_EQ(arr, (std::vector<int>{11, 12, 22, 25, 34, 64, 90}));
+}
+
+TEST(SampleSortTest, SortsEmptyAndSingleElementArrays) {
+  std::vector<int> empty;
+  sampleSort(empty);
+  parallelSampleSort(empty, 4);
+  EXPECT_TRUE(empty.empty());
+  std::vector<int> single = {1};
+  sampleSort(single);
+  EXPECT_EQ(single, std::vector<int>{1});
+}
+
+TEST(SampleSortTest, MatchesStdSortOnPatterns) {
+  for (std::size_t n : {5000u, 100000u}) {
+    for (int pattern = 0; pattern < 4; ++pattern) {
+      auto arr = patternInts(n, pattern);
+      auto expected = arr;
+      std::ranges::sort(expected);
+      sampleSort(arr);
+      EXPECT_EQ(arr, expected) << "n = " << n << ", pattern " << pattern;
+    }
+  }
+}
+
+TEST(SampleSortTest, ParallelMatchesStdSort) {
+  for (std::size_t threads : {2u, 3u, 8u}) {
+    for (int pattern = 0; pattern < 4; ++pattern) {
+      auto arr = patternInts(300000, pattern);
+      auto expected = arr;
+      std::ranges::sort(expected);
+      parallelSampleSort(arr, threads);
+      EXPECT_EQ(arr, expected) << threads << " threads, pattern " << pattern;
+    }
+  }
+}
+
+TEST(SampleSortTest, SortsMoveOnlyElementsWithProjection) {
+  std::mt19937 gen(42);
+  std::vector<std::unique_ptr<int>> arr(50000);
+  for (auto& value : arr) {
+    value = std::make_unique<int>(static_cast<int>(gen() % 1000));
+  }
+  auto key = [](const std::unique_ptr<int>& p) { return *p; };
+  parallelSampleSort(arr, std::ranges::greater{}, key, 4);
+  EXPECT_TRUE(std::ranges::is_sorted(arr, std::ranges::greater{}, key));
+  sampleSort(arr, std::ranges::less{}, key);
+  EXPECT_TRUE(std::ranges::is_sorted(arr, std::ranges::less{}, key));
+}
+
+TEST(SampleSortTest, SortsStrings) {
+  std::mt19937 gen(43);
+  std::vector<std::string> arr(20000);
+  for (auto& value : arr) {
+    value = "key" + std::to_string(gen() % 5000);
+  }
+  auto expected = arr;
+  std::ranges::sort(expected);
+  sampleSort(arr);
+  EXPECT_EQ(arr, expected);
+}
+
+TEST(SampleSortTest, SortedInputTakesLinearComparisons) {
+  std::vector<int> arr(100000);
+  std::iota(arr.begin(), arr.end(), 0);
+  std::ranges::reverse(arr);
+  SortStats stats;
+  sampleSort(arr, CountingSortObserver{stats});
+  EXPECT_TRUE(std::ranges::is_sorted(arr));
+  EXPECT_EQ(stats.comparisons, arr.size() - 1);
+}
+
+TEST(SampleSortTest, ScratchIsIndependentOfInputSize) {
+  auto arr = patternInts(1 << 20, 0);
+  SortStats stats;
+  sampleSort(arr, CountingSortObserver{stats});
+  EXPECT_TRUE(std::ranges::is_sorted(arr));
+  // 256 bucket blocks plus two swap blocks of 2 KiB each.
+  EXPECT_LE(stats.allocatedBytes, 258u * kSampleSortBlockBytes);
+  EXPECT_GT(stats.maxDepth, 0u);
+}
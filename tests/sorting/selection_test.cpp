@@ -0,0 +1,133 @@
+#include "../../src/sorting/selection.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "../../src/sorting/sort_observer.hpp"
+
+namespace {
+
+std::vector<int> randomInts(std::size_t n, int range, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::vector<int> arr(n);
+  for (auto& x : arr) x = static_cast<int>(gen() % static_cast<unsigned>(range));
+  return arr;
+}
+
+void expectSelected(const std::vector<int>& arr, std::size_t nth, const std::vector<int>& sorted) {
+  ASSERT_EQ(arr[nth], sorted[nth]);
+  for (std::size_t i = 0; i < nth; ++i) ASSERT_LE(arr[i], arr[nth]);
+  for (std::size_t i = nth + 1; i < arr.size(); ++i) ASSERT_GE(arr[i], arr[nth]);
+}
+
+// Copyable but without a default constructor.
+struct Score {
+  explicit Score(int v) : value(v) {}
+  int value;
+};
+
+}  // namespace
+
+TEST(NthElementTest, SelectsEveryRankOfSmallInput) {
+  auto base = randomInts(50, 20, 1);
+  auto sorted = base;
+  std::ranges::sort(sorted);
+  for (std::size_t nth = 0; nth < base.size(); ++nth) {
+    auto arr = base;
+    nthElement(arr, nth);
+    expectSelected(arr, nth, sorted);
+  }
+}
+
+TEST(NthElementTest, SelectsMedianAndTailOfLargeInput) {
+  for (int range : {1 << 30, 100, 2}) {
+    auto base = randomInts(200000, range, 2);
+    auto sorted = base;
+    std::ranges::sort(sorted);
+    for (std::size_t nth : {std::size_t{0}, base.size() / 2, base.size() * 99 / 100,
+                            base.size() - 1}) {
+      auto arr = base;
+      nthElement(arr, nth);
+      expectSelected(arr, nth, sorted);
+    }
+  }
+}
+
+TEST(NthElementTest, IsLinearOnSortedAndOrganPipeInputs) {
+  std::vector<int> arr(100000);
+  std::iota(arr.begin(), arr.begin() + 50000, 0);
+  std::iota(arr.rbegin(), arr.rbegin() + 50000, 0);
+  SortStats stats;
+  nthElement(arr, arr.size() / 2, CountingSortObserver{stats});
+  EXPECT_EQ(arr[arr.size() / 2], 25000);
+  EXPECT_LT(stats.comparisons, 3 * arr.size());
+}
+
+TEST(NthElementTest, MedianOfMediansFallbackSelects) {
+  auto base = randomInts(5000, 300, 3);
+  auto sorted = base;
+  std::ranges::sort(sorted);
+  for (std::size_t nth : {std::size_t{0}, std::size_t{1234}, std::size_t{4999}}) {
+    auto arr = base;
+    medianOfMediansSelect(arr.begin(), arr.begin() + static_cast<std::ptrdiff_t>(nth),
+                          arr.end(), std::less<>{});
+    expectSelected(arr, nth, sorted);
+  }
+}
+
+TEST(NthElementTest, HonorsComparatorAndProjection) {
+  std::vector<std::pair<int, char>> arr = {{5, 'a'}, {1, 'b'}, {4, 'c'}, {2, 'd'}, {3, 'e'}};
+  nthElement(arr, arr.begin() + 1, std::ranges::greater{}, &std::pair<int, char>::first);
+  EXPECT_EQ(arr[1].first, 4);
+}
+
+TEST(PartialSortTest, SortsSmallestPrefix) {
+  auto arr = randomInts(10000, 1000, 4);
+  auto sorted = arr;
+  std::ranges::sort(sorted);
+  partialSort(arr, 100);
+  EXPECT_TRUE(std::equal(arr.begin(), arr.begin() + 100, sorted.begin()));
+  std::ranges::sort(arr);
+  EXPECT_EQ(arr, sorted);
+}
+
+TEST(PartialSortTest, HandlesEmptyAndFullPrefix) {
+  std::vector<int> arr = {3, 1, 2};
+  partialSort(arr, 0);
+  EXPECT_EQ(arr, (std::vector<int>{3, 1, 2}));
+  partialSort(arr, 3);
+  EXPECT_EQ(arr, (std::vector<int>{1, 2, 3}));
+}
+
+TEST(TopKTest, ReturnsLargestInDescendingOrder) {
+  auto arr = randomInts(100000, 1 << 30, 5);
+  const auto original = arr;
+  auto expected = arr;
+  std::ranges::sort(expected, std::ranges::greater{});
+  expected.resize(1000);
+  EXPECT_EQ(topK(arr, 1000), expected);
+  EXPECT_EQ(arr, original);
+}
+
+TEST(TopKTest, HonorsComparatorAndSmallInputs) {
+  std::vector<int> arr = {5, 1, 4, 2, 3};
+  EXPECT_EQ(topK(arr, 2, std::ranges::less{}), (std::vector<int>{1, 2}));
+  EXPECT_EQ(topK(arr, 10), (std::vector<int>{5, 4, 3, 2, 1}));
+  EXPECT_TRUE(topK(arr, 0).empty());
+}
+
+TEST(TopKTest, AcceptsElementsWithoutDefaultConstructor) {
+  std::vector<Score> scores;
+  for (int v : randomInts(5000, 1000, 6)) scores.emplace_back(v);
+  auto expected = randomInts(5000, 1000, 6);
+  std::ranges::sort(expected, std::ranges::greater{});
+  auto best = topK(scores, 100, std::ranges::greater{}, &Score::value);
+  ASSERT_EQ(best.size(), 100u);
+  for (std::size_t i = 0; i < best.size(); ++i) EXPECT_EQ(best[i].value, expected[i]);
+}
@@ -2,6 +2,10 @@
 
 #include <gtest/gtest.h>
 
+#include <functional>
+#include <utility>
+#include <vector>
+
 TEST(ShellSortTest, SortsIntegerArray) {
   std::vector<int> arr = {64, 34, 25, 12, 22, 11, 90};
   std::vector<int> expected = {11, 12, 22, 25, 34, 64, 90};
@@ -21,3 +25,9 @@ TEST(ShellSortTest, HandlesRepeatedElements) {
   shellSort(arr);
   EXPECT_EQ(arr, expected);
 }
+
+TEST(ShellSortTest, SortsByProjection) {
+  std::vector<std::pair<int, char>> arr = {{3, 'c'}, {1, 'a'}, {2, 'b'}};
+  shellSort(arr, std::ranges::less{}, &std::pair<int, char>::first);
+  EXPECT_EQ(arr, (std::vector<std::pair<int, char>>{{1, 'a'}, {2, 'b'}, {3, 'c'}}));
+}
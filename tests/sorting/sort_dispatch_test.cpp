@@ -0,0 +1,145 @@
+#include "../../src/sorting/sort_dispatch.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+std::vector<std::uint32_t> randomKeys(std::size_t n, std::uint32_t range, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::vector<std::uint32_t> keys(n);
+  for (auto& x : keys) x = static_cast<std::uint32_t>(gen() % range);
+  return keys;
+}
+
+template <typename T, typename Compare = std::ranges::less>
+clavis::SortAlgorithm sortAndCheck(std::vector<T> values, clavis::SortOptions opts = {},
+                                   Compare comp = {}) {
+  auto expected = values;
+  std::ranges::sort(expected, comp);
+  auto algorithm = clavis::sort(values, opts, comp);
+  EXPECT_EQ(values, expected);
+  return algorithm;
+}
+
+}  // namespace
+
+TEST(SortDispatchTest, PicksAlgorithmByInputShape) {
+  using clavis::SortAlgorithm;
+  EXPECT_EQ(sortAndCheck(randomKeys(40, 1000, 1)), SortAlgorithm::kSmallSort);
+  EXPECT_EQ(sortAndCheck(randomKeys(100000, 1u << 31, 2)), SortAlgorithm::kRadixSort);
+  EXPECT_EQ(sortAndCheck(randomKeys(100000, 8, 3)), SortAlgorithm::kPdqSort);
+
+  auto nearlySorted = randomKeys(100000, 1u << 31, 4);
+  std::ranges::sort(nearlySorted);
+  std::swap(nearlySorted[10], nearlySorted[50000]);
+  EXPECT_EQ(sortAndCheck(nearlySorted), SortAlgorithm::kPowerSort);
+  std::ranges::reverse(nearlySorted);
+  EXPECT_EQ(sortAndCheck(nearlySorted), SortAlgorithm::kPowerSort);
+
+  std::vector<std::string> words;
+  for (auto key : randomKeys(5000, 1u << 20, 5)) words.push_back(std::to_string(key));
+  EXPECT_EQ(sortAndCheck(words), SortAlgorithm::kPdqSort);
+  EXPECT_EQ(sortAndCheck(randomKeys(5000, 1u << 31, 6), {}, std::ranges::greater{}),
+            SortAlgorithm::kPdqSort);
+}
+
+TEST(SortDispatchTest, StableSortKeepsInputOrderOfEqualKeys) {
+  using Entry = std::pair<std::uint32_t, int>;
+  for (std::size_t n : {30u, 3000u, 200000u}) {
+    std::vector<Entry> entries;
+    int i = 0;
+    for (auto key : randomKeys(n, 100, static_cast<unsigned>(n))) entries.push_back({key, i++});
+    auto expected = entries;
+    std::ranges::stable_sort(expected, {}, &Entry::first);
+    auto algorithm = clavis::sort(entries, {.stable = true}, {}, &Entry::first);
+    EXPECT_EQ(entries, expected);
+    EXPECT_NE(algorithm, clavis::SortAlgorithm::kPdqSort);
+  }
+}
+
+TEST(SortDispatchTest, SortsNonContiguousAndParallel) {
+  auto keys = randomKeys(20000, 1u << 31, 7);
+  std::deque<std::uint32_t> deque(keys.begin(), keys.end());
+  EXPECT_EQ(clavis::sort(deque), clavis::SortAlgorithm::kPdqSort);
+  EXPECT_TRUE(std::ranges::is_sorted(deque));
+
+  auto previous = clavis::sortThresholds();
+  auto thresholds = previous;
+  thresholds.parallelMinSize = 10000;
+  clavis::setSortThresholds(thresholds);
+  EXPECT_EQ(sortAndCheck(keys, {.threads = 4}), clavis::SortAlgorithm::kParallelRadixSort);
+  std::vector<double> reals(keys.begin(), keys.end());
+  EXPECT_EQ(sortAndCheck(reals, {.stable = true, .threads = 4}),
+            clavis::SortAlgorithm::kParallelMergeSort);
+  EXPECT_EQ(sortAndCheck(reals, {.threads = 4}, std::ranges::greater{}),
+            clavis::SortAlgorithm::kParallelSampleSort);
+  clavis::setSortThresholds(previous);
+}
+
+TEST(SortDispatchTest, UncalibratedRadixThresholdNeverPicksRadix) {
+  auto previous = clavis::sortThresholds();
+  auto thresholds = previous;
+  thresholds.radixMinSize = std::numeric_limits<std::ptrdiff_t>::max();
+  clavis::setSortThresholds(thresholds);
+  std::vector<std::uint64_t> wide(600);
+  std::mt19937_64 gen(8);
+  for (auto& x : wide) x = gen();
+  EXPECT_EQ(sortAndCheck(wide), clavis::SortAlgorithm::kPdqSort);
+  EXPECT_EQ(sortAndCheck(randomKeys(100000, 1u << 31, 9)), clavis::SortAlgorithm::kPdqSort);
+  clavis::setSortThresholds(previous);
+}
+
+TEST(SortDispatchTest, ProbeMeasuresRunsAndDuplicates) {
+  std::vector<int> ascending(1000);
+  for (int i = 0; i < 1000; ++i) ascending[i] = i;
+  auto probe = clavis::probeSortInput(ascending.begin(), ascending.end(), std::less<>{});
+  EXPECT_EQ(probe.ascending, 1.0);
+  EXPECT_EQ(probe.descending, 0.0);
+  EXPECT_EQ(probe.duplicates, 0.0);
+
+  std::vector<int> equal(1000, 3);
+  probe = clavis::probeSortInput(equal.begin(), equal.end(), std::less<>{});
+  EXPECT_EQ(probe.ascending, 1.0);
+  EXPECT_EQ(probe.descending, 1.0);
+  EXPECT_EQ(probe.duplicates, 1.0);
+}
+
+TEST(SortDispatchTest, ThresholdsRoundTripAndValidate) {
+  clavis::SortThresholds thresholds{4096, 1 << 20, 0.75, 0.3};
+  std::stringstream stream;
+  clavis::writeSortThresholds(stream, thresholds);
+  EXPECT_EQ(clavis::readSortThresholds(stream), thresholds);
+
+  std::istringstream partial("radixMinSize 77\n");
+  EXPECT_EQ(clavis::readSortThresholds(partial).radixMinSize, 77);
+  std::istringstream unknown("radixMinSize 77\nbogus 1\n");
+  EXPECT_THROW(clavis::readSortThresholds(unknown), std::invalid_argument);
+  std::istringstream malformed("parallelMinSize many\n");
+  EXPECT_THROW(clavis::readSortThresholds(malformed), std::invalid_argument);
+
+  thresholds.duplicateFraction = 1.5;
+  EXPECT_THROW(clavis::setSortThresholds(thresholds), std::invalid_argument);
+  thresholds.duplicateFraction = 0.5;
+  thresholds.radixMinSize = 0;
+  EXPECT_THROW(clavis::setSortThresholds(thresholds), std::invalid_argument);
+}
+
+TEST(SortDispatchTest, CalibrationProducesUsableThresholds) {
+  auto thresholds = clavis::calibrateSortThresholds();
+  EXPECT_GT(thresholds.radixMinSize, 0);
+  EXPECT_GT(thresholds.parallelMinSize, 0);
+  EXPECT_NO_THROW(clavis::setSortThresholds(thresholds));
+  clavis::setSortThresholds({});
+}
@@ -0,0 +1,115 @@
+#include "../../src/sorting/sort_observer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../../src/sorting/bubble_sort.hpp"
+#include "../../src/sorting/heap_sort.hpp"
+#include "../../src/sorting/insertion_sort.hpp"
+#include "../../src/sorting/merge_sort.hpp"
+#include "../../src/sorting/quick_sort.hpp"
+#include "../../src/sorting/radix_sort.hpp"
+#include "../../src/sorting/shell_sort.hpp"
+
+namespace {
+
+std::vector<int> randomInts(std::size_t n) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> dist(-1000, 1000);
+  std::vector<int> arr(n);
+  std::ranges::generate(arr, [&] { return dist(gen); });
+  return arr;
+}
+
+}  // namespace
+
+TEST(SortObserverTest, NullObserverIsEmpty) {
+  static_assert(SortObserver<NullSortObserver>);
+  static_assert(std::is_empty_v<NullSortObserver>);
+}
+
+TEST(SortObserverTest, BubbleSortCountsEveryComparisonAndSwap) {
+  std::vector<int> arr = {3, 2, 1};
+  SortStats stats;
+  bubbleSort(arr, CountingSortObserver{stats});
+  EXPECT_EQ(arr, (std::vector<int>{1, 2, 3}));
+  EXPECT_EQ(stats.comparisons, 3u);
+  EXPECT_EQ(stats.swaps, 3u);
+}
+
+TEST(SortObserverTest, InsertionSortCountsNothingOnSortedInput) {
+  std::vector<int> arr = {1, 2, 3, 4, 5};
+  SortStats stats;
+  insertionSort(arr, CountingSortObserver{stats});
+  EXPECT_EQ(stats.comparisons, 4u);
+  EXPECT_EQ(stats.moves, 0u);
+}
+
+TEST(SortObserverTest, QuickSortReportsDepthAndWork) {
+  auto arr = randomInts(10000);
+  auto expected = arr;
+  std::ranges::sort(expected);
+  SortStats stats;
+  quickSort(arr, CountingSortObserver{stats});
+  EXPECT_EQ(arr, expected);
+  EXPECT_GT(stats.comparisons, 10000u);
+  EXPECT_GT(stats.swaps, 0u);
+  EXPECT_GT(stats.maxDepth, 0u);
+  EXPECT_LE(stats.maxDepth, 2u * 14u);
+  EXPECT_EQ(stats.allocatedBytes, 0u);
+}
+
+TEST(SortObserverTest, MergeSortReportsScratchAllocation) {
+  auto arr = randomInts(1000);
+  auto expected = arr;
+  std::ranges::sort(expected);
+  SortStats stats;
+  mergeSort(arr, CountingSortObserver{stats});
+  EXPECT_EQ(arr, expected);
+  EXPECT_EQ(stats.allocatedBytes, 1000u * sizeof(int));
+  EXPECT_GT(stats.comparisons, 0u);
+  // Runs of 32 are merged in five passes: 64, 128, 256, 512, 1024.
+  EXPECT_EQ(stats.maxDepth, 5u);
+}
+
+TEST(SortObserverTest, RadixSortCountsScatterPasses) {
+  std::vector<int> arr(1000);
+  for (std::size_t i = 0; i < arr.size(); ++i) {
+    arr[i] = static_cast<int>((arr.size() - i) * 300);
+  }
+  auto expected = arr;
+  std::ranges::sort(expected);
+  SortStats stats;
+  radixSort(arr, CountingSortObserver{stats});
+  EXPECT_EQ(arr, expected);
+  EXPECT_EQ(stats.comparisons, 0u);
+  EXPECT_EQ(stats.maxDepth, 3u);
+  EXPECT_EQ(stats.allocatedBytes, 1000u * sizeof(int));
+}
+
+TEST(SortObserverTest, HeapAndShellSortAcceptObservers) {
+  auto arr = randomInts(500);
+  auto copy = arr;
+  auto expected = arr;
+  std::ranges::sort(expected);
+  SortStats heapStats;
+  SortStats shellStats;
+  heapSort(arr, CountingSortObserver{heapStats});
+  shellSort(copy, CountingSortObserver{shellStats});
+  EXPECT_EQ(arr, expected);
+  EXPECT_EQ(copy, expected);
+  EXPECT_GT(heapStats.swaps, 0u);
+  EXPECT_GT(shellStats.moves, 0u);
+}
+
+TEST(SortObserverTest, TracingObserverWritesEvents) {
+  std::vector<int> arr = {2, 1};
+  std::ostringstream out;
+  bubbleSort(arr, TracingSortObserver{out});
+  EXPECT_EQ(out.str(), "compare\nswap\n");
+}
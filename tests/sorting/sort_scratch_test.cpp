@@ -0,0 +1,58 @@
+#include "../../src/sorting/sort_scratch.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <memory_resource>
+#include <thread>
+
+TEST(SortScratchLeaseTest, UsesCallerResourceWhenGiven) {
+  std::pmr::unsynchronized_pool_resource pool;
+  SortScratchLease small(16, &pool);
+  SortScratchLease large(kSortScratchArenaBytes * 4, &pool);
+  EXPECT_EQ(small.resource(), &pool);
+  EXPECT_EQ(large.resource(), &pool);
+}
+
+TEST(SortScratchLeaseTest, SmallRequestsShareTheThreadArena) {
+  std::pmr::memory_resource* arena;
+  void* first;
+  {
+    SortScratchLease lease(256);
+    arena = lease.resource();
+    EXPECT_NE(arena, std::pmr::get_default_resource());
+    first = arena->allocate(256);
+    arena->deallocate(first, 256);
+  }
+  {
+    // The arena is rewound once the last lease ends.
+    SortScratchLease lease(256);
+    EXPECT_EQ(lease.resource(), arena);
+    void* again = lease.resource()->allocate(256);
+    EXPECT_EQ(again, first);
+    lease.resource()->deallocate(again, 256);
+  }
+
+  SortScratchLease large(kSortScratchArenaBytes + 1);
+  EXPECT_EQ(large.resource(), std::pmr::get_default_resource());
+
+  std::pmr::memory_resource* other = nullptr;
+  std::thread([&other] { other = SortScratchLease(64).resource(); }).join();
+  EXPECT_NE(other, arena);
+}
+
+TEST(SortScratchLeaseTest, NestedLeasesKeepOuterScratchAlive) {
+  SortScratchLease outer(1024);
+  auto* outerBytes = static_cast<unsigned char*>(outer.resource()->allocate(1024));
+  outerBytes[0] = 42;
+  {
+    SortScratchLease inner(kSortScratchArenaBytes);
+    void* innerBytes = inner.resource()->allocate(kSortScratchArenaBytes);
+    EXPECT_NE(innerBytes, static_cast<void*>(outerBytes));
+    static_cast<unsigned char*>(innerBytes)[0] = 7;
+    inner.resource()->deallocate(innerBytes, kSortScratchArenaBytes);
+  }
+  void* next = outer.resource()->allocate(16);
+  EXPECT_NE(next, static_cast<void*>(outerBytes));
+  EXPECT_EQ(outerBytes[0], 42);
+}
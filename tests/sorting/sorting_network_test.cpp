@@ -0,0 +1,107 @@
+#include "../../src/sorting/sorting_network.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <vector>
+
+template <typename T>
+class SortingNetworkTest : public ::testing::Test {};
+
+using SortingNetworkTypes =
+    ::testing::Types<std::int32_t, std::uint32_t, float, std::int64_t, std::uint64_t, double>;
+TYPED_TEST_SUITE(SortingNetworkTest, SortingNetworkTypes);
+
+TYPED_TEST(SortingNetworkTest, SortsEveryBlockSize) {
+  std::mt19937_64 gen(99);
+  for (size_t n = 0; n <= static_cast<size_t>(kSortingNetworkMaxSize); ++n) {
+    std::vector<TypeParam> arr(n);
+    for (auto& x : arr) {
+      x = static_cast<TypeParam>(static_cast<int64_t>(gen() % 2001) - 1000);
+    }
+    if (n > 2) {
+      arr[0] = std::numeric_limits<TypeParam>::max();
+      arr[1] = std::numeric_limits<TypeParam>::lowest();
+    }
+    std::vector<TypeParam> expected = arr;
+    std::sort(expected.begin(), expected.end());
+    sortingNetworkSort(arr.data(), arr.size());
+    EXPECT_EQ(arr, expected) << "n = " << n;
+  }
+}
+
+TYPED_TEST(SortingNetworkTest, SmallSortHonorsCustomComparator) {
+  std::vector<TypeParam> arr = {3, 1, 4, 1, 5, 9, 2, 6};
+  smallSort(arr.begin(), arr.end(), std::greater<>{});
+  std::vector<TypeParam> expected = {9, 6, 5, 4, 3, 2, 1, 1};
+  EXPECT_EQ(arr, expected);
+}
+
+#if CLAVIS_HAS_AVX2_KERNELS
+TYPED_TEST(SortingNetworkTest, VectorMergeMatchesScalarMerge) {
+  if (!sortingNetworkAvailable()) {
+    GTEST_SKIP() << "AVX2 not supported";
+  }
+  std::mt19937_64 gen(5);
+  for (int round = 0; round < 200; ++round) {
+    std::vector<TypeParam> a(gen() % 70);
+    std::vector<TypeParam> b(gen() % 70);
+    for (auto& x : a) x = static_cast<TypeParam>(gen() % 50);
+    for (auto& x : b) x = static_cast<TypeParam>(gen() % 50 + (round % 3) * 25);
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    std::vector<TypeParam> expected(a.size() + b.size());
+    std::merge(a.begin(), a.end(), b.begin(), b.end(), expected.begin());
+    std::vector<TypeParam> merged(expected.size());
+    simdMergeRuns(a.data(), a.size(), b.data(), b.size(), merged.data());
+    EXPECT_EQ(merged, expected);
+  }
+}
+
+TYPED_TEST(SortingNetworkTest, VectorMergeOfAdjacentRunsStaysInBounds) {
+  if (!sortingNetworkAvailable()) {
+    GTEST_SKIP() << "AVX2 not supported";
+  }
+  // The lower run is exhausted first and ends where the upper one starts.
+  for (std::size_t lower : {std::size_t{3}, std::size_t{kSimdLanes<TypeParam> + 3}}) {
+    std::vector<TypeParam> runs;
+    for (std::size_t i = 0; i < lower; ++i) runs.push_back(static_cast<TypeParam>(i));
+    for (int i = 0; i < 10; ++i) runs.push_back(static_cast<TypeParam>(100 + i));
+    std::vector<TypeParam> merged(runs.size());
+    simdMergeRuns(runs.data(), lower, runs.data() + lower, runs.size() - lower, merged.data());
+    EXPECT_EQ(merged, runs) << "lower = " << lower;
+  }
+}
+#endif
+
+template <typename T>
+void expectNanInputStaysPermutation() {
+  std::mt19937_64 gen(7);
+  for (size_t n = 2; n <= static_cast<size_t>(kSortingNetworkMaxSize); ++n) {
+    std::vector<T> arr(n);
+    for (auto& x : arr) x = static_cast<T>(gen() % 100);
+    arr[gen() % n] = std::numeric_limits<T>::quiet_NaN();
+    std::vector<T> expected = arr;
+    smallSort(arr.begin(), arr.end(), std::less<>{});
+    // NaNs compare unordered, so only the multiset of values is checked.
+    auto nanLast = [](T a, T b) { return std::isnan(a) ? false : std::isnan(b) || a < b; };
+    std::sort(arr.begin(), arr.end(), nanLast);
+    std::sort(expected.begin(), expected.end(), nanLast);
+    EXPECT_EQ(std::count_if(arr.begin(), arr.end(), [](T x) { return std::isnan(x); }), 1)
+        << "n = " << n;
+    EXPECT_TRUE(std::equal(arr.begin(), arr.end() - 1, expected.begin())) << "n = " << n;
+  }
+}
+
+TEST(SortingNetworkNanTest, KeepsEveryElementOfFloatInput) {
+  expectNanInputStaysPermutation<float>();
+}
+
+TEST(SortingNetworkNanTest, KeepsEveryElementOfDoubleInput) {
+  expectNanInputStaysPermutation<double>();
+}
@@ -0,0 +1,142 @@
+#include "../../src/sorting/string_sort.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// URL-like keys: a handful of hosts and paths sharing long prefixes, with
+// duplicates, proper prefixes and bytes above 0x7f mixed in.
+std::vector<std::string> makeUrls(std::size_t n, unsigned seed) {
+  std::mt19937 gen(seed);
+  const std::vector<std::string> hosts = {"https://example.com/", "https://example.org/",
+                                          "http://example.com/", "https://ex.io/"};
+  std::vector<std::string> urls;
+  urls.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    std::string url = hosts[gen() % hosts.size()];
+    auto segments = gen() % 4;
+    for (unsigned s = 0; s < segments; ++s) {
+      url += "api/v" + std::to_string(gen() % 3) + "/";
+    }
+    if (gen() % 5 != 0) {
+      url += std::to_string(gen() % 1000);
+    }
+    if (gen() % 17 == 0) {
+      url += static_cast<char>(0x80 + gen() % 0x80);
+    }
+    urls.push_back(std::move(url));
+  }
+  return urls;
+}
+
+}  // namespace
+
+TEST(MultikeyQuickSortTest, SortsStrings) {
+  std::vector<std::string> words = {"banana", "apple", "", "app", "cherry", "apple", "b"};
+  std::vector<std::string> expected = words;
+  std::ranges::sort(expected);
+  multikeyQuickSort(words);
+  EXPECT_EQ(words, expected);
+}
+
+TEST(MultikeyQuickSortTest, MatchesStdSortOnUrls) {
+  auto urls = makeUrls(20000, 3);
+  auto expected = urls;
+  std::ranges::sort(expected);
+  multikeyQuickSort(urls);
+  EXPECT_EQ(urls, expected);
+}
+
+TEST(MsdStringSortTest, MatchesStdSortOnUrlsAndStringViews) {
+  auto urls = makeUrls(50000, 5);
+  std::vector<std::string_view> views(urls.begin(), urls.end());
+  auto expected = urls;
+  std::ranges::sort(expected);
+  msdStringSort(views);
+  EXPECT_TRUE(std::ranges::equal(views, expected));
+  msdStringSort(urls);
+  EXPECT_EQ(urls, expected);
+}
+
+TEST(MsdStringSortTest, HandlesEmptyEqualAndPrefixStrings) {
+  std::vector<std::string> empty;
+  msdStringSort(empty);
+  EXPECT_TRUE(empty.empty());
+  std::vector<std::string> same(1000, std::string(300, 'x'));
+  msdStringSort(same);
+  EXPECT_EQ(same, std::vector<std::string>(1000, std::string(300, 'x')));
+  std::vector<std::string> prefixes;
+  for (std::size_t length = 600; length-- > 0;) {
+    prefixes.push_back(std::string(length, 'a'));
+  }
+  msdStringSort(prefixes);
+  EXPECT_TRUE(std::ranges::is_sorted(prefixes));
+}
+
+TEST(LcpMergeSortTest, MatchesStdSortOnUrls) {
+  auto urls = makeUrls(30000, 7);
+  auto expected = urls;
+  std::ranges::sort(expected);
+  lcpMergeSort(urls);
+  EXPECT_EQ(urls, expected);
+}
+
+TEST(LcpMergeSortTest, IsStableUnderProjection) {
+  std::mt19937 gen(11);
+  std::vector<std::pair<std::string, int>> records;
+  for (int i = 0; i < 5000; ++i) {
+    records.emplace_back("log/" + std::to_string(gen() % 50), i);
+  }
+  auto expected = records;
+  std::ranges::stable_sort(expected, {}, &std::pair<std::string, int>::first);
+  lcpMergeSort(records, &std::pair<std::string, int>::first);
+  EXPECT_EQ(records, expected);
+}
+
+TEST(StringSortTest, SortsRecordsByProjectedKeyAndCStrings) {
+  struct Record {
+    std::string key;
+    int value;
+  };
+  std::vector<Record> records = {{"pear", 1}, {"fig", 2}, {"peach", 3}, {"date", 4}};
+  multikeyQuickSort(records, &Record::key);
+  std::vector<std::string> keys;
+  for (const auto& record : records) {
+    keys.push_back(record.key);
+  }
+  EXPECT_EQ(keys, (std::vector<std::string>{"date", "fig", "peach", "pear"}));
+  EXPECT_EQ(records[0].value, 4);
+
+  std::vector<const char*> names = {"gamma", "alpha", "beta"};
+  msdStringSort(names);
+  EXPECT_EQ(std::string_view(names[0]), "alpha");
+  EXPECT_EQ(std::string_view(names[2]), "gamma");
+}
+
+TEST(StringSortTest, OrdersEmbeddedZeroBytesAfterShorterPrefixes) {
+  std::mt19937 gen(13);
+  std::vector<std::string> keys;
+  for (int i = 0; i < 3000; ++i) {
+    std::string key(gen() % 20, '\0');
+    for (auto& c : key) {
+      c = static_cast<char>(gen() % 3 == 0 ? 'a' : '\0');
+    }
+    keys.push_back(std::move(key));
+  }
+  auto expected = keys;
+  std::ranges::sort(expected);
+  for (auto sort : {+[](std::vector<std::string>& v) { multikeyQuickSort(v); },
+                    +[](std::vector<std::string>& v) { msdStringSort(v); },
+                    +[](std::vector<std::string>& v) { lcpMergeSort(v); }}) {
+    auto sorted = keys;
+    sort(sorted);
+    EXPECT_EQ(sorted, expected);
+  }
+}